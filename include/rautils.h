@@ -10,14 +10,26 @@
 #include "rautils/db/sqlite.h"
 #include "rautils/exceptions/exceptions.h"
 #include "rautils/misc/atomic_queue.h"
+#include "rautils/misc/concurrent_map.h"
+#include "rautils/misc/flat_map.h"
+#include "rautils/misc/histogram.h"
 #include "rautils/misc/map_handler.h"
 #include "rautils/misc/mime_types.h"
+#include "rautils/misc/mpmc_queue.h"
+#include "rautils/misc/spsc_queue.h"
 #include "rautils/misc/status.h"
 #include "rautils/misc/thread_id.h"
+#include "rautils/misc/thread_pool.h"
+#include "rautils/misc/thread_slots.h"
 #include "rautils/misc/uid.h"
 #include "rautils/network/general.h"
 #include "rautils/network/request.h"
 #include "rautils/network/websocket.h"
+#include "rautils/string/case_fold.h"
+#include "rautils/string/char_set.h"
+#include "rautils/string/hex.h"
+#include "rautils/string/random_string.h"
+#include "rautils/string/search.h"
 #include "rautils/string/strtool.h"
 #include "rautils/system/subprocess.h"
 
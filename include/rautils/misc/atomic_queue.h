@@ -1,10 +1,15 @@
 #ifndef RA_UTILS_RAUTILS_MISC_ATOMIC_QUEUE_H_
 #define RA_UTILS_RAUTILS_MISC_ATOMIC_QUEUE_H_
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <queue>
 #include <utility>
+#include <vector>
 
 namespace rayalto::utils::misc {
 
@@ -21,6 +26,8 @@ public:
 
     virtual ~AtomicQueue() = default;
 
+    // the reference escapes the lock, with more than one consumer use
+    // pop_into(), wait_pop() or drain() instead
     T& front() {
         std::lock_guard<std::mutex> lock(mutex_);
         return queue_.front();
@@ -42,19 +49,28 @@ public:
     }
 
     void push(const T& value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.push(value);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push(value);
+        }
+        not_empty_.notify_one();
     }
 
     void push(T&& value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.push(std::move(value));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push(std::move(value));
+        }
+        not_empty_.notify_one();
     }
 
     template <typename... Args>
     decltype(auto) emplace(Args&&... value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.emplace(std::forward<Args>(value)...);
+        std::unique_lock<std::mutex> lock(mutex_);
+        decltype(auto) result = queue_.emplace(std::forward<Args>(value)...);
+        lock.unlock();
+        not_empty_.notify_one();
+        return result;
     }
 
     void pop() {
@@ -67,9 +83,48 @@ public:
         return queue_.swap(q.queue_);
     }
 
+    // move the front into `out` and pop it, return false if empty
+    bool pop_into(T& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            return false;
+        }
+        out = std::move(queue_.front());
+        queue_.pop();
+        return true;
+    }
+
+    // like pop_into(), but wait up to `timeout` for a value
+    template <typename Rep, typename Period>
+    bool wait_pop(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!not_empty_.wait_for(
+                lock, timeout, [this]() { return !queue_.empty(); })) {
+            return false;
+        }
+        out = std::move(queue_.front());
+        queue_.pop();
+        return true;
+    }
+
+    // append at most `max_count` values to `out` under one lock, return how
+    // many
+    std::size_t drain(std::vector<T>& out,
+                      const std::size_t& max_count = SIZE_MAX) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t count = std::min(queue_.size(), max_count);
+        out.reserve(out.size() + count);
+        for (std::size_t i = 0; i < count; i++) {
+            out.emplace_back(std::move(queue_.front()));
+            queue_.pop();
+        }
+        return count;
+    }
+
 protected:
     std::queue<T> queue_;
     std::mutex mutex_;
+    std::condition_variable not_empty_;
 };
 
 } // namespace rayalto::utils::misc
@@ -0,0 +1,338 @@
+#ifndef RA_UTILS_RAUTILS_MISC_CONCURRENT_MAP_H_
+#define RA_UTILS_RAUTILS_MISC_CONCURRENT_MAP_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rayalto::utils::misc {
+
+// std::hash, but std::string keys hash as std::string_view so lookups do
+// not need to build a std::string
+template <typename Key>
+struct TransparentHash {
+    std::size_t operator()(const Key& key) const {
+        return std::hash<Key> {}(key);
+    }
+};
+
+template <>
+struct TransparentHash<std::string> {
+    std::size_t operator()(const std::string_view& key) const {
+        return std::hash<std::string_view> {}(key);
+    }
+};
+
+/**
+ * Thread-safe map split into lock-striped shards, a key only ever locks
+ * its own shard. Lookups are heterogeneous (e.g. std::string_view for
+ * std::string keys). Optionally bounded with least-recently-used eviction
+ * and/or entries expiring after a time to live. Values are returned by
+ * copy since another thread may erase them right after.
+ * Example:
+ *      ConcurrentMap<std::string, Address> dns_cache(16, 4096, 60s);
+ *      Address address = dns_cache.get_or_insert_with(
+ *          host, [&]() { return resolve(host); });
+ */
+template <typename Key, typename Value, typename Hash = TransparentHash<Key>>
+class ConcurrentMap {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // `shards` is rounded up to a power of two, `capacity` 0 for unbounded,
+    // `time_to_live` 0 for entries that never expire
+    explicit ConcurrentMap(const std::size_t& shards = 16,
+                           const std::size_t& capacity = 0,
+                           const Clock::duration& time_to_live =
+                               Clock::duration::zero());
+
+    ConcurrentMap(const ConcurrentMap&) = delete;
+    ConcurrentMap(ConcurrentMap&&) noexcept = delete;
+    ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+    ConcurrentMap& operator=(ConcurrentMap&&) noexcept = delete;
+
+    virtual ~ConcurrentMap() = default;
+
+    // copy of the value, std::nullopt if missing or expired
+    template <typename Lookup>
+    std::optional<Value> get(const Lookup& key);
+
+    template <typename Lookup>
+    bool contains(const Lookup& key);
+
+    // return false (and keep the old value) if the key already exists
+    bool insert(const Key& key, const Value& value);
+    bool insert(Key&& key, Value&& value);
+
+    void insert_or_assign(const Key& key, const Value& value);
+    void insert_or_assign(Key&& key, Value&& value);
+
+    // the value of `key`, calling `make()` to insert it if missing. make()
+    // runs under the shard lock, so at most once per missing key
+    template <typename Lookup, typename Make>
+    Value get_or_insert_with(const Lookup& key, Make&& make);
+
+    // return false if the key does not exist
+    template <typename Lookup>
+    bool erase(const Lookup& key);
+
+    void clear();
+
+    // including expired entries not yet collected
+    [[nodiscard]] std::size_t size() const;
+
+    // call `function(const Key&, Value&)` on every entry, one shard locked
+    // at a time
+    template <typename Function>
+    void for_each(Function&& function);
+
+protected:
+    struct Entry {
+        Value value;
+        Clock::time_point expires_at;
+        // position in Shard::lru
+        typename std::list<const Key*>::iterator lru_position;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::map<Key, Entry, std::less<>> entries;
+        // most recently used first, points to keys in entries
+        std::list<const Key*> lru;
+    };
+
+    using Iterator = typename std::map<Key, Entry, std::less<>>::iterator;
+
+    template <typename Lookup>
+    Shard& shard_(const Lookup& key);
+    // find `key`, dropping it if expired, and mark it used
+    template <typename Lookup>
+    Iterator find_(Shard& shard, const Lookup& key);
+    // insert a new entry and evict beyond capacity
+    template <typename K, typename V>
+    Iterator emplace_(Shard& shard, K&& key, V&& value);
+    void erase_(Shard& shard, const Iterator& entry);
+
+    const std::size_t shard_mask_;
+    const std::size_t shard_capacity_;
+    const Clock::duration time_to_live_;
+    const std::unique_ptr<Shard[]> shards_;
+};
+
+template <typename Key, typename Value, typename Hash>
+ConcurrentMap<Key, Value, Hash>::ConcurrentMap(
+    const std::size_t& shards,
+    const std::size_t& capacity,
+    const Clock::duration& time_to_live) :
+    shard_mask_([&]() {
+        std::size_t count = 1;
+        while (count < shards) {
+            count <<= 1;
+        }
+        return count - 1;
+    }()),
+    shard_capacity_(capacity == 0 ? 0
+                                  : (capacity + shard_mask_) / (shard_mask_ + 1)),
+    time_to_live_(time_to_live),
+    shards_(std::make_unique<Shard[]>(shard_mask_ + 1)) {}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Lookup>
+std::optional<Value> ConcurrentMap<Key, Value, Hash>::get(const Lookup& key) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Iterator found = find_(shard, key);
+    if (found == shard.entries.end()) {
+        return std::nullopt;
+    }
+    return found->second.value;
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Lookup>
+bool ConcurrentMap<Key, Value, Hash>::contains(const Lookup& key) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return find_(shard, key) != shard.entries.end();
+}
+
+template <typename Key, typename Value, typename Hash>
+bool ConcurrentMap<Key, Value, Hash>::insert(const Key& key,
+                                             const Value& value) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (find_(shard, key) != shard.entries.end()) {
+        return false;
+    }
+    emplace_(shard, key, value);
+    return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool ConcurrentMap<Key, Value, Hash>::insert(Key&& key, Value&& value) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (find_(shard, key) != shard.entries.end()) {
+        return false;
+    }
+    emplace_(shard, std::move(key), std::move(value));
+    return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ConcurrentMap<Key, Value, Hash>::insert_or_assign(const Key& key,
+                                                       const Value& value) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Iterator found = find_(shard, key);
+    if (found == shard.entries.end()) {
+        emplace_(shard, key, value);
+        return;
+    }
+    found->second.value = value;
+    found->second.expires_at = Clock::now() + time_to_live_;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ConcurrentMap<Key, Value, Hash>::insert_or_assign(Key&& key,
+                                                       Value&& value) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Iterator found = find_(shard, key);
+    if (found == shard.entries.end()) {
+        emplace_(shard, std::move(key), std::move(value));
+        return;
+    }
+    found->second.value = std::move(value);
+    found->second.expires_at = Clock::now() + time_to_live_;
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Lookup, typename Make>
+Value ConcurrentMap<Key, Value, Hash>::get_or_insert_with(const Lookup& key,
+                                                          Make&& make) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Iterator found = find_(shard, key);
+    if (found == shard.entries.end()) {
+        found = emplace_(shard, Key(key), make());
+    }
+    return found->second.value;
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Lookup>
+bool ConcurrentMap<Key, Value, Hash>::erase(const Lookup& key) {
+    Shard& shard = shard_(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Iterator found = shard.entries.find(key);
+    if (found == shard.entries.end()) {
+        return false;
+    }
+    erase_(shard, found);
+    return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ConcurrentMap<Key, Value, Hash>::clear() {
+    for (std::size_t i = 0; i <= shard_mask_; i++) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        shards_[i].lru.clear();
+        shards_[i].entries.clear();
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+std::size_t ConcurrentMap<Key, Value, Hash>::size() const {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i <= shard_mask_; i++) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        size += shards_[i].entries.size();
+    }
+    return size;
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Function>
+void ConcurrentMap<Key, Value, Hash>::for_each(Function&& function) {
+    for (std::size_t i = 0; i <= shard_mask_; i++) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        for (auto& [key, entry] : shards_[i].entries) {
+            function(key, entry.value);
+        }
+    }
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Lookup>
+typename ConcurrentMap<Key, Value, Hash>::Shard&
+ConcurrentMap<Key, Value, Hash>::shard_(const Lookup& key) {
+    // fibonacci hashing, std::hash of integers is often the identity
+    const std::uint64_t hash =
+        static_cast<std::uint64_t>(Hash {}(key)) * 0x9e3779b97f4a7c15ULL;
+    return shards_[static_cast<std::size_t>(hash >> 32) & shard_mask_];
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename Lookup>
+typename ConcurrentMap<Key, Value, Hash>::Iterator
+ConcurrentMap<Key, Value, Hash>::find_(Shard& shard, const Lookup& key) {
+    Iterator found = shard.entries.find(key);
+    if (found == shard.entries.end()) {
+        return found;
+    }
+    if (time_to_live_ != Clock::duration::zero()
+        && found->second.expires_at <= Clock::now()) {
+        erase_(shard, found);
+        return shard.entries.end();
+    }
+    if (shard_capacity_ != 0) {
+        shard.lru.splice(
+            shard.lru.begin(), shard.lru, found->second.lru_position);
+    }
+    return found;
+}
+
+template <typename Key, typename Value, typename Hash>
+template <typename K, typename V>
+typename ConcurrentMap<Key, Value, Hash>::Iterator
+ConcurrentMap<Key, Value, Hash>::emplace_(Shard& shard, K&& key, V&& value) {
+    if (shard_capacity_ != 0 && shard.entries.size() >= shard_capacity_) {
+        // evict the least recently used
+        erase_(shard, shard.entries.find(*shard.lru.back()));
+    }
+    Iterator entry =
+        shard.entries
+            .emplace(std::forward<K>(key),
+                     Entry {std::forward<V>(value),
+                            Clock::now() + time_to_live_,
+                            shard.lru.end()})
+            .first;
+    if (shard_capacity_ != 0) {
+        shard.lru.push_front(&entry->first);
+        entry->second.lru_position = shard.lru.begin();
+    }
+    return entry;
+}
+
+template <typename Key, typename Value, typename Hash>
+void ConcurrentMap<Key, Value, Hash>::erase_(Shard& shard,
+                                             const Iterator& entry) {
+    if (shard_capacity_ != 0) {
+        shard.lru.erase(entry->second.lru_position);
+    }
+    shard.entries.erase(entry);
+}
+
+} // namespace rayalto::utils::misc
+
+#endif // RA_UTILS_RAUTILS_MISC_CONCURRENT_MAP_H_
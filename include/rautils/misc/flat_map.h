@@ -0,0 +1,488 @@
+#ifndef RA_UTILS_RAUTILS_MISC_FLAT_MAP_H_
+#define RA_UTILS_RAUTILS_MISC_FLAT_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rayalto::utils::misc {
+
+// whether `Compare` accepts keys of other types, like std::less<>
+template <typename Compare, typename = void>
+struct IsTransparent : std::false_type {};
+
+template <typename Compare>
+struct IsTransparent<Compare, std::void_t<typename Compare::is_transparent>> :
+    std::true_type {};
+
+/**
+ * std::map look-alike storing its items in one sorted std::vector, so a
+ * small map is a single allocation and iterating it does not chase
+ * pointers. Lookup is a binary search, insert/erase shift the following
+ * items, good for maps with a few dozen items that are mostly built once
+ * and then read. Unlike std::map, insert/erase invalidate iterators and
+ * the key in `iterator->first` must not be modified. With a transparent
+ * Compare (std::less<>, LessIC) lookups accept e.g. std::string_view.
+ * Example:
+ *      FlatMap<std::string, std::string> header {{"Accept", "text/html"}};
+ *      header["User-Agent"] = "ra-utils";
+ *      for (const auto& [name, value] : header) { ... }
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using key_compare = Compare;
+    using container_type = std::vector<value_type>;
+    using size_type = std::size_t;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    // enables the heterogeneous lookups, iterators still go to erase()
+    template <typename K>
+    using TransparentKey = std::enable_if_t<
+        IsTransparent<Compare>::value
+            && !std::is_convertible_v<const K&, const_iterator>,
+        int>;
+
+    explicit FlatMap(const Compare& compare);
+    template <typename InputIt>
+    FlatMap(InputIt first, InputIt last, const Compare& compare = Compare());
+    FlatMap(std::initializer_list<std::pair<const Key, Value>> items,
+            const Compare& compare = Compare());
+
+    FlatMap() = default;
+    FlatMap(const FlatMap&) = default;
+    FlatMap(FlatMap&&) noexcept = default;
+
+    FlatMap& operator=(const FlatMap&) = default;
+    FlatMap& operator=(FlatMap&&) noexcept = default;
+
+    virtual ~FlatMap() = default;
+
+    Value& operator[](const Key& key);
+    Value& operator[](Key&& key);
+
+    // throw std::out_of_range if the key does not exist, like std::map
+    Value& at(const Key& key);
+    const Value& at(const Key& key) const;
+
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator cbegin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cend() const noexcept;
+
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] size_type size() const noexcept;
+    void clear() noexcept;
+    void reserve(const size_type& capacity);
+
+    iterator find(const Key& key);
+    const_iterator find(const Key& key) const;
+    [[nodiscard]] size_type count(const Key& key) const;
+    iterator lower_bound(const Key& key);
+    const_iterator lower_bound(const Key& key) const;
+
+    template <typename K, TransparentKey<K> = 0>
+    iterator find(const K& key) {
+        return find_(*this, key);
+    }
+    template <typename K, TransparentKey<K> = 0>
+    const_iterator find(const K& key) const {
+        return find_(*this, key);
+    }
+    template <typename K, TransparentKey<K> = 0>
+    [[nodiscard]] size_type count(const K& key) const {
+        return find_(*this, key) == items_.end() ? 0 : 1;
+    }
+    template <typename K, TransparentKey<K> = 0>
+    iterator lower_bound(const K& key) {
+        return lower_bound_(*this, key);
+    }
+    template <typename K, TransparentKey<K> = 0>
+    const_iterator lower_bound(const K& key) const {
+        return lower_bound_(*this, key);
+    }
+
+    // keep the existing item if the key already exists, like std::map
+    std::pair<iterator, bool> insert(const value_type& item);
+    std::pair<iterator, bool> insert(value_type&& item);
+    // O(1) if `hint` is where the item belongs, e.g. inserting in order
+    iterator insert(const_iterator hint, const value_type& item);
+    iterator insert(const_iterator hint, value_type&& item);
+    // append everything then sort once instead of shifting per item
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+    void insert(std::initializer_list<std::pair<const Key, Value>> items);
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    size_type erase(const Key& key);
+    template <typename K, TransparentKey<K> = 0>
+    size_type erase(const K& key) {
+        return erase_(key);
+    }
+
+    void swap(FlatMap& other) noexcept;
+
+    key_compare key_comp() const;
+
+    // the sorted items
+    const container_type& items() const noexcept;
+
+protected:
+    // whether `key` sorts before the item
+    template <typename K>
+    bool key_before_(const K& key, const value_type& item) const;
+    // whether the item sorts before `key`
+    template <typename K>
+    bool item_before_(const value_type& item, const K& key) const;
+    // shared by the const and non-const lookups
+    template <typename Self, typename K>
+    static auto lower_bound_(Self& self, const K& key)
+        -> decltype(self.items_.begin());
+    template <typename Self, typename K>
+    static auto find_(Self& self, const K& key) -> decltype(self.items_.begin());
+    template <typename K>
+    size_type erase_(const K& key);
+    template <typename V>
+    iterator insert_at_(const_iterator pos, V&& item);
+
+    container_type items_;
+    Compare compare_;
+};
+
+template <typename Key, typename Value, typename Compare>
+FlatMap<Key, Value, Compare>::FlatMap(const Compare& compare) :
+    compare_(compare) {}
+
+template <typename Key, typename Value, typename Compare>
+template <typename InputIt>
+FlatMap<Key, Value, Compare>::FlatMap(InputIt first,
+                                      InputIt last,
+                                      const Compare& compare) :
+    compare_(compare) {
+    insert(first, last);
+}
+
+template <typename Key, typename Value, typename Compare>
+FlatMap<Key, Value, Compare>::FlatMap(
+    std::initializer_list<std::pair<const Key, Value>> items,
+    const Compare& compare) :
+    compare_(compare) {
+    insert(items.begin(), items.end());
+}
+
+template <typename Key, typename Value, typename Compare>
+Value& FlatMap<Key, Value, Compare>::operator[](const Key& key) {
+    iterator found = lower_bound(key);
+    if (found == items_.end() || key_before_(key, *found)) {
+        found = items_.emplace(found, key, Value());
+    }
+    return found->second;
+}
+
+template <typename Key, typename Value, typename Compare>
+Value& FlatMap<Key, Value, Compare>::operator[](Key&& key) {
+    iterator found = lower_bound(key);
+    if (found == items_.end() || key_before_(key, *found)) {
+        found = items_.emplace(found, std::move(key), Value());
+    }
+    return found->second;
+}
+
+template <typename Key, typename Value, typename Compare>
+Value& FlatMap<Key, Value, Compare>::at(const Key& key) {
+    iterator found = find(key);
+    if (found == items_.end()) {
+        throw std::out_of_range("FlatMap::at");
+    }
+    return found->second;
+}
+
+template <typename Key, typename Value, typename Compare>
+const Value& FlatMap<Key, Value, Compare>::at(const Key& key) const {
+    const_iterator found = find(key);
+    if (found == items_.end()) {
+        throw std::out_of_range("FlatMap::at");
+    }
+    return found->second;
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::begin() noexcept {
+    return items_.begin();
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::const_iterator
+FlatMap<Key, Value, Compare>::begin() const noexcept {
+    return items_.begin();
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::const_iterator
+FlatMap<Key, Value, Compare>::cbegin() const noexcept {
+    return items_.cbegin();
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::end() noexcept {
+    return items_.end();
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::const_iterator
+FlatMap<Key, Value, Compare>::end() const noexcept {
+    return items_.end();
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::const_iterator
+FlatMap<Key, Value, Compare>::cend() const noexcept {
+    return items_.cend();
+}
+
+template <typename Key, typename Value, typename Compare>
+bool FlatMap<Key, Value, Compare>::empty() const noexcept {
+    return items_.empty();
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::size_type
+FlatMap<Key, Value, Compare>::size() const noexcept {
+    return items_.size();
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::clear() noexcept {
+    items_.clear();
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::reserve(const size_type& capacity) {
+    items_.reserve(capacity);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::find(const Key& key) {
+    return find_(*this, key);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::const_iterator
+FlatMap<Key, Value, Compare>::find(const Key& key) const {
+    return find_(*this, key);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::size_type
+FlatMap<Key, Value, Compare>::count(const Key& key) const {
+    return find_(*this, key) == items_.end() ? 0 : 1;
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::lower_bound(const Key& key) {
+    return lower_bound_(*this, key);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::const_iterator
+FlatMap<Key, Value, Compare>::lower_bound(const Key& key) const {
+    return lower_bound_(*this, key);
+}
+
+template <typename Key, typename Value, typename Compare>
+std::pair<typename FlatMap<Key, Value, Compare>::iterator, bool>
+FlatMap<Key, Value, Compare>::insert(const value_type& item) {
+    iterator found = lower_bound(item.first);
+    if (found != items_.end() && !key_before_(item.first, *found)) {
+        return {found, false};
+    }
+    return {items_.insert(found, item), true};
+}
+
+template <typename Key, typename Value, typename Compare>
+std::pair<typename FlatMap<Key, Value, Compare>::iterator, bool>
+FlatMap<Key, Value, Compare>::insert(value_type&& item) {
+    iterator found = lower_bound(item.first);
+    if (found != items_.end() && !key_before_(item.first, *found)) {
+        return {found, false};
+    }
+    return {items_.insert(found, std::move(item)), true};
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::insert(const_iterator hint,
+                                     const value_type& item) {
+    return insert_at_(hint, item);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::insert(const_iterator hint, value_type&& item) {
+    return insert_at_(hint, std::move(item));
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename InputIt>
+void FlatMap<Key, Value, Compare>::insert(InputIt first, InputIt last) {
+    const size_type previous_size = items_.size();
+    for (; first != last; ++first) {
+        items_.emplace_back(first->first, first->second);
+    }
+    if (items_.size() == previous_size) {
+        return;
+    }
+    // stable, so for equal keys the existing/first inserted item comes
+    // first and survives the unique below, same as std::map
+    std::stable_sort(items_.begin(),
+                     items_.end(),
+                     [this](const value_type& l, const value_type& r) -> bool {
+                         return item_before_(l, r.first);
+                     });
+    items_.erase(
+        std::unique(items_.begin(),
+                    items_.end(),
+                    [this](const value_type& l, const value_type& r) -> bool {
+                        return !item_before_(l, r.first);
+                    }),
+        items_.end());
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::insert(
+    std::initializer_list<std::pair<const Key, Value>> items) {
+    insert(items.begin(), items.end());
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename... Args>
+std::pair<typename FlatMap<Key, Value, Compare>::iterator, bool>
+FlatMap<Key, Value, Compare>::emplace(Args&&... args) {
+    return insert(value_type(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::erase(const_iterator pos) {
+    return items_.erase(pos);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::erase(const_iterator first,
+                                    const_iterator last) {
+    return items_.erase(first, last);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::size_type
+FlatMap<Key, Value, Compare>::erase(const Key& key) {
+    return erase_(key);
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::swap(FlatMap& other) noexcept {
+    using std::swap;
+    swap(items_, other.items_);
+    swap(compare_, other.compare_);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename FlatMap<Key, Value, Compare>::key_compare
+FlatMap<Key, Value, Compare>::key_comp() const {
+    return compare_;
+}
+
+template <typename Key, typename Value, typename Compare>
+const typename FlatMap<Key, Value, Compare>::container_type&
+FlatMap<Key, Value, Compare>::items() const noexcept {
+    return items_;
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename K>
+bool FlatMap<Key, Value, Compare>::key_before_(const K& key,
+                                               const value_type& item) const {
+    return compare_(key, item.first);
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename K>
+bool FlatMap<Key, Value, Compare>::item_before_(const value_type& item,
+                                                const K& key) const {
+    return compare_(item.first, key);
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename Self, typename K>
+auto FlatMap<Key, Value, Compare>::lower_bound_(Self& self, const K& key)
+    -> decltype(self.items_.begin()) {
+    return std::lower_bound(
+        self.items_.begin(),
+        self.items_.end(),
+        key,
+        [&self](const value_type& item, const K& k) -> bool {
+            return self.item_before_(item, k);
+        });
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename Self, typename K>
+auto FlatMap<Key, Value, Compare>::find_(Self& self, const K& key)
+    -> decltype(self.items_.begin()) {
+    auto found = lower_bound_(self, key);
+    if (found == self.items_.end() || self.key_before_(key, *found)) {
+        return self.items_.end();
+    }
+    return found;
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename K>
+typename FlatMap<Key, Value, Compare>::size_type
+FlatMap<Key, Value, Compare>::erase_(const K& key) {
+    const_iterator found = find_(*this, key);
+    if (found == items_.end()) {
+        return 0;
+    }
+    items_.erase(found);
+    return 1;
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename V>
+typename FlatMap<Key, Value, Compare>::iterator
+FlatMap<Key, Value, Compare>::insert_at_(const_iterator pos, V&& item) {
+    // the hint is right if the item goes between its neighbours
+    const bool after_previous =
+        pos == items_.cbegin() || item_before_(*std::prev(pos), item.first);
+    const bool before_next =
+        pos == items_.cend() || key_before_(item.first, *pos);
+    if (after_previous && before_next) {
+        return items_.insert(pos, std::forward<V>(item));
+    }
+    return insert(std::forward<V>(item)).first;
+}
+
+} // namespace rayalto::utils::misc
+
+#endif // RA_UTILS_RAUTILS_MISC_FLAT_MAP_H_
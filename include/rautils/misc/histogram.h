@@ -0,0 +1,58 @@
+#ifndef RA_UTILS_RAUTILS_MISC_HISTOGRAM_H_
+#define RA_UTILS_RAUTILS_MISC_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rayalto::utils::misc {
+
+/**
+ * Lock-free histogram of unsigned integer samples (e.g. latency in
+ * microseconds), every power of two is split into 16 buckets, so reported
+ * values are at most ~6% off
+ */
+class Histogram {
+public:
+    Histogram() = default;
+    Histogram(const Histogram&) = delete;
+    Histogram(Histogram&&) noexcept = delete;
+    Histogram& operator=(const Histogram&) = delete;
+    Histogram& operator=(Histogram&&) noexcept = delete;
+
+    virtual ~Histogram() = default;
+
+    // add a sample, safe to call from any thread
+    void record(const std::uint64_t& value);
+    // drop all samples
+    void reset();
+
+    [[nodiscard]] std::uint64_t count() const;
+    [[nodiscard]] std::uint64_t sum() const;
+    [[nodiscard]] std::uint64_t min() const;
+    [[nodiscard]] std::uint64_t max() const;
+    [[nodiscard]] double mean() const;
+    // value that `percentile` (0 ~ 100) percent of samples are not above
+    [[nodiscard]] std::uint64_t percentile(const double& percentile) const;
+
+protected:
+    static constexpr std::size_t SUB_BUCKET_BITS = 4;
+    static constexpr std::size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr std::size_t BUCKET_COUNT =
+        (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    static std::size_t bucket_index_(const std::uint64_t& value);
+    // largest value falls into the bucket
+    static std::uint64_t bucket_value_(const std::size_t& index);
+
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_ {};
+    std::atomic<std::uint64_t> count_ = 0;
+    std::atomic<std::uint64_t> sum_ = 0;
+    std::atomic<std::uint64_t> min_ = UINT64_MAX;
+    std::atomic<std::uint64_t> max_ = 0;
+};
+
+} // namespace rayalto::utils::misc
+
+#endif // RA_UTILS_RAUTILS_MISC_HISTOGRAM_H_
@@ -1,45 +1,77 @@
 #ifndef RA_UTILS_UTIL_MAP_HANDLER_H_
 #define RA_UTILS_UTIL_MAP_HANDLER_H_
 
-#include <algorithm> // std::lexicographical_compare
-#include <cctype> // std::tolower
 #include <cstddef>
 #include <initializer_list>
 #include <map>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 
+#include "rautils/misc/flat_map.h"
+#include "rautils/string/case_fold.h"
+
 namespace rayalto::utils::misc {
 
 /**
- * Ignore case version of std::less
+ * Ignore case (ascii) version of std::less<>, transparent so maps using it
+ * can be searched with std::string_view/const char* without building a
+ * std::string
  */
 struct LessIC {
-    struct LessCompareIC {
-        bool operator()(const unsigned char& lc,
-                        const unsigned char& rc) const noexcept {
-            return std::tolower(lc) < std::tolower(rc);
-        }
-    };
-    bool operator()(const std::string& lv,
-                    const std::string& rv) const noexcept {
-        return std::lexicographical_compare(
-            lv.begin(), lv.end(), rv.begin(), rv.end(), LessCompareIC());
+    using is_transparent = void;
+
+    bool operator()(const std::string_view& lv,
+                    const std::string_view& rv) const noexcept {
+        return string::casecmp(lv, rv) < 0;
+    }
+};
+
+/**
+ * Ignore case (ascii) versions of std::hash and std::equal_to for unordered
+ * containers
+ */
+struct HashIC {
+    using is_transparent = void;
+
+    std::size_t operator()(const std::string_view& str) const noexcept {
+        return string::hash_ic(str);
+    }
+};
+
+struct EqualIC {
+    using is_transparent = void;
+
+    bool operator()(const std::string_view& lv,
+                    const std::string_view& rv) const noexcept {
+        return string::equals_ic(lv, rv);
     }
 };
 
 // imitating dict in python
 using Dict = std::map<std::string, std::string>;
+// Dict searchable by std::string_view/const char* without building a
+// std::string
+using TransparentDict = std::map<std::string, std::string, std::less<>>;
 // imitating dict in python, case insensitive version
 using DictIC = std::map<std::string, std::string, LessIC>;
+// sorted std::vector versions of Dict and DictIC
+using FlatDict = FlatMap<std::string, std::string, std::less<>>;
+using FlatDictIC = FlatMap<std::string, std::string, LessIC>;
+// hash table version of DictIC
+using UnorderedDictIC =
+    std::unordered_map<std::string, std::string, HashIC, EqualIC>;
 
 /**
  * Stupid wrap of std::map<std::string, ValueType> with virtual destructor
- * and some extra stupid functions, case insensitive version
+ * and some extra stupid functions, case insensitive version. `Container`
+ * can be FlatMap for small maps that are mostly built once and iterated
  */
-template <typename ValueType>
+template <typename ValueType, template <typename...> class Container = std::map>
 class MapIc {
-    using MapType = std::map<std::string, ValueType, LessIC>;
+    using MapType = Container<std::string, ValueType, LessIC>;
     using iterator = typename MapType::iterator;
     using const_iterator = typename MapType::const_iterator;
 
@@ -59,8 +91,12 @@ public:
 
     virtual ~MapIc() = default;
 
-    std::string& operator[](const std::string& name) {
-        return map_[name];
+    ValueType& operator[](const std::string_view& name) {
+        iterator found = map_.find(name);
+        if (found == map_.end()) {
+            found = map_.emplace(std::string(name), ValueType()).first;
+        }
+        return found->second;
     }
 
     iterator begin() {
@@ -99,11 +135,11 @@ public:
         return map_.size();
     }
 
-    iterator find(const std::string& key) {
+    iterator find(const std::string_view& key) {
         return map_.find(key);
     }
 
-    const_iterator find(const std::string& key) const {
+    const_iterator find(const std::string_view& key) const {
         return map_.find(key);
     }
 
@@ -149,12 +185,12 @@ public:
     }
 
     // test whether a key exists
-    [[nodiscard]] bool exists(const std::string& key) const {
-        return (map_.find(key) == map_.end());
+    [[nodiscard]] bool exists(const std::string_view& key) const {
+        return map_.find(key) != map_.end();
     }
 
     // try to remove an item by key, return false if the key does not exists
-    bool remove(const std::string& key) {
+    bool remove(const std::string_view& key) {
         const_iterator found = map_.find(key);
         if (found == map_.end()) {
             return false;
@@ -164,9 +200,9 @@ public:
     }
 
     // try to remove items by key, return the amount of items actually removed
-    std::size_t remove(std::initializer_list<std::string> keys) {
+    std::size_t remove(std::initializer_list<std::string_view> keys) {
         std::size_t count = 0;
-        for (const std::string& key : keys) {
+        for (const std::string_view& key : keys) {
             if (remove(key)) {
                 count += 1;
             }
@@ -188,7 +224,7 @@ public:
     std::size_t add(
         std::initializer_list<std::pair<std::string, ValueType>> items) {
         std::size_t count = 0;
-        for (std::pair<std::string, std::string> item : items) {
+        for (const std::pair<std::string, ValueType>& item : items) {
             if (add(item)) {
                 count += 1;
             }
@@ -198,7 +234,7 @@ public:
 
     // try to update/add an item, return false if a same item is already exists
     bool update(const std::pair<std::string, ValueType>& item) {
-        std::string& previous_value = map_[item.first];
+        ValueType& previous_value = map_[item.first];
         if (previous_value == item.second) {
             return false;
         }
@@ -208,7 +244,7 @@ public:
 
     // try to update/add an item, return false if a same item is already exists
     bool update(std::pair<std::string, ValueType>&& item) {
-        std::string& previous_value = map_[item.first];
+        ValueType& previous_value = map_[item.first];
         if (previous_value == item.second) {
             return false;
         }
@@ -220,7 +256,7 @@ public:
     std::size_t update(
         std::initializer_list<std::pair<std::string, ValueType>> items) {
         std::size_t count = 0;
-        for (std::pair<std::string, std::string> item : items) {
+        for (const std::pair<std::string, ValueType>& item : items) {
             if (update(item)) {
                 count += 1;
             }
@@ -242,17 +278,24 @@ protected:
 
 /**
  * Stupid wrap of std::map<std::string, ValueType> with virtual destructor
- * and some extra stupid functions
+ * and some extra stupid functions. `Container` can be FlatMap for small
+ * maps that are mostly built once and iterated
  */
-template <typename ValueType>
+template <typename ValueType, template <typename...> class Container = std::map>
 class Map {
-    using MapType = std::map<std::string, ValueType>;
+    using MapType = Container<std::string, ValueType, std::less<>>;
     using iterator = typename MapType::iterator;
     using const_iterator = typename MapType::const_iterator;
 
 public:
     explicit Map(const MapType& map) : map_(map) {}
     explicit Map(MapType&& map) : map_(std::move(map)) {}
+    // from the same container with another comparison, e.g. a plain Dict
+    template <typename Compare,
+              typename = std::enable_if_t<
+                  !std::is_same_v<Compare, std::less<>>>>
+    explicit Map(const Container<std::string, ValueType, Compare>& map) :
+        map_(map.begin(), map.end()) {}
     Map(std::initializer_list<std::pair<const std::string, ValueType>> pairs) :
         map_(pairs) {}
 
@@ -265,8 +308,12 @@ public:
 
     virtual ~Map() = default;
 
-    std::string& operator[](const std::string& name) {
-        return map_[name];
+    ValueType& operator[](const std::string_view& name) {
+        iterator found = map_.find(name);
+        if (found == map_.end()) {
+            found = map_.emplace(std::string(name), ValueType()).first;
+        }
+        return found->second;
     }
 
     iterator begin() {
@@ -305,11 +352,11 @@ public:
         return map_.size();
     }
 
-    iterator find(const std::string& key) {
+    iterator find(const std::string_view& key) {
         return map_.find(key);
     }
 
-    const_iterator find(const std::string& key) const {
+    const_iterator find(const std::string_view& key) const {
         return map_.find(key);
     }
 
@@ -355,12 +402,12 @@ public:
     }
 
     // test whether a key exists
-    [[nodiscard]] bool exists(const std::string& key) const {
-        return (map_.find(key) == map_.end());
+    [[nodiscard]] bool exists(const std::string_view& key) const {
+        return map_.find(key) != map_.end();
     }
 
     // try to remove an item by key, return false if the key does not exists
-    bool remove(const std::string& key) {
+    bool remove(const std::string_view& key) {
         const_iterator found = map_.find(key);
         if (found == map_.end()) {
             return false;
@@ -370,9 +417,9 @@ public:
     }
 
     // try to remove items by key, return the amount of items actually removed
-    std::size_t remove(std::initializer_list<std::string> keys) {
+    std::size_t remove(std::initializer_list<std::string_view> keys) {
         std::size_t count = 0;
-        for (const std::string& key : keys) {
+        for (const std::string_view& key : keys) {
             if (remove(key)) {
                 count += 1;
             }
@@ -394,7 +441,7 @@ public:
     std::size_t add(
         std::initializer_list<std::pair<std::string, ValueType>> items) {
         std::size_t count = 0;
-        for (std::pair<std::string, ValueType> item : items) {
+        for (const std::pair<std::string, ValueType>& item : items) {
             if (add(item)) {
                 count += 1;
             }
@@ -404,7 +451,7 @@ public:
 
     // try to update/add an item, return false if a same item is already exists
     bool update(const std::pair<std::string, ValueType>& item) {
-        std::string& previous_value = map_[item.first];
+        ValueType& previous_value = map_[item.first];
         if (previous_value == item.second) {
             return false;
         }
@@ -414,7 +461,7 @@ public:
 
     // try to update/add an item, return false if a same item is already exists
     bool update(std::pair<std::string, ValueType>&& item) {
-        std::string& previous_value = map_[item.first];
+        ValueType& previous_value = map_[item.first];
         if (previous_value == item.second) {
             return false;
         }
@@ -426,7 +473,7 @@ public:
     std::size_t update(
         std::initializer_list<std::pair<std::string, ValueType>> items) {
         std::size_t count = 0;
-        for (std::pair<std::string, std::string> item : items) {
+        for (const std::pair<std::string, ValueType>& item : items) {
             if (update(item)) {
                 count += 1;
             }
@@ -448,6 +495,8 @@ protected:
 
 using DictHandler = Map<std::string>;
 using DictIcHandler = MapIc<std::string>;
+using FlatDictHandler = Map<std::string, FlatMap>;
+using FlatDictIcHandler = MapIc<std::string, FlatMap>;
 
 } // namespace rayalto::utils::misc
 
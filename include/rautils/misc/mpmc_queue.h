@@ -0,0 +1,239 @@
+#ifndef RA_UTILS_RAUTILS_MISC_MPMC_QUEUE_H_
+#define RA_UTILS_RAUTILS_MISC_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rayalto::utils::misc {
+
+/**
+ * Bounded lock-free multi-producer multi-consumer queue (Dmitry Vyukov's
+ * ring), every slot carries a sequence number so producers and consumers
+ * only contend on their own end. Capacity is rounded up to a power of two.
+ * Example:
+ *      MpmcQueue<int> queue(1024);
+ *      queue.try_push(1);
+ *      int value;
+ *      if (queue.try_pop(value)) { ... }
+ */
+template <typename T>
+class MpmcQueue {
+public:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    explicit MpmcQueue(const std::size_t& capacity);
+
+    MpmcQueue() = delete;
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue(MpmcQueue&&) noexcept = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(MpmcQueue&&) noexcept = delete;
+
+    virtual ~MpmcQueue();
+
+    // return false if the queue is full
+    bool try_push(const T& value);
+    bool try_push(T&& value);
+    template <typename... Args>
+    bool try_emplace(Args&&... args);
+
+    // return false if the queue is empty
+    bool try_pop(T& value);
+
+    // push [first, last) until the queue is full, return how many were
+    // pushed (moved from)
+    template <typename Iterator>
+    std::size_t try_push_bulk(Iterator first, Iterator last);
+    // pop at most `max_count` values into `out`, return how many
+    template <typename OutputIterator>
+    std::size_t try_pop_bulk(OutputIterator out, const std::size_t& max_count);
+
+    [[nodiscard]] const std::size_t& capacity() const;
+    // only a snapshot while other threads are using the queue
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+protected:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static std::size_t round_up_(std::size_t capacity);
+    // claim the next filled cell and hand its value to `consume` as T&&,
+    // return false if the queue is empty
+    template <typename Consume>
+    bool pop_with_(Consume&& consume);
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    const std::unique_ptr<Cell[]> cells_;
+    // each end on its own cache line
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_position_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_position_ = 0;
+};
+
+template <typename T>
+MpmcQueue<T>::MpmcQueue(const std::size_t& capacity) :
+    capacity_(round_up_(capacity)),
+    mask_(capacity_ - 1),
+    cells_(std::make_unique<Cell[]>(capacity_)) {
+    for (std::size_t i = 0; i < capacity_; i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+MpmcQueue<T>::~MpmcQueue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::size_t position =
+            dequeue_position_.load(std::memory_order_relaxed);
+        const std::size_t end = enqueue_position_.load(std::memory_order_relaxed);
+        for (; position != end; position++) {
+            std::launder(
+                reinterpret_cast<T*>(&cells_[position & mask_].storage))
+                ->~T();
+        }
+    }
+}
+
+template <typename T>
+bool MpmcQueue<T>::try_push(const T& value) {
+    return try_emplace(value);
+}
+
+template <typename T>
+bool MpmcQueue<T>::try_push(T&& value) {
+    return try_emplace(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+bool MpmcQueue<T>::try_emplace(Args&&... args) {
+    std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+        cell = &cells_[position & mask_];
+        const std::size_t sequence =
+            cell->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence)
+                                - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            // the slot is free, claim it
+            if (enqueue_position_.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            // a whole lap behind, full
+            return false;
+        }
+        else {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+    }
+    new (&cell->storage) T(std::forward<Args>(args)...);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool MpmcQueue<T>::try_pop(T& value) {
+    return pop_with_([&value](T&& stored) { value = std::move(stored); });
+}
+
+template <typename T>
+template <typename Consume>
+bool MpmcQueue<T>::pop_with_(Consume&& consume) {
+    std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+        cell = &cells_[position & mask_];
+        const std::size_t sequence =
+            cell->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence)
+                                - static_cast<std::ptrdiff_t>(position + 1);
+        if (difference == 0) {
+            // the slot is filled, claim it
+            if (dequeue_position_.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            // not filled yet, empty
+            return false;
+        }
+        else {
+            position = dequeue_position_.load(std::memory_order_relaxed);
+        }
+    }
+    T* stored = std::launder(reinterpret_cast<T*>(&cell->storage));
+    consume(std::move(*stored));
+    stored->~T();
+    // free for the producer one lap later
+    cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+template <typename Iterator>
+std::size_t MpmcQueue<T>::try_push_bulk(Iterator first, Iterator last) {
+    std::size_t count = 0;
+    for (; first != last && try_push(std::move(*first)); ++first) {
+        count++;
+    }
+    return count;
+}
+
+template <typename T>
+template <typename OutputIterator>
+std::size_t MpmcQueue<T>::try_pop_bulk(OutputIterator out,
+                                       const std::size_t& max_count) {
+    std::size_t count = 0;
+    // straight from the cell, T need not be default constructible
+    while (count < max_count && pop_with_([&out](T&& stored) {
+               *out = std::move(stored);
+               ++out;
+           })) {
+        count++;
+    }
+    return count;
+}
+
+template <typename T>
+const std::size_t& MpmcQueue<T>::capacity() const {
+    return capacity_;
+}
+
+template <typename T>
+std::size_t MpmcQueue<T>::size() const {
+    const std::size_t enqueued =
+        enqueue_position_.load(std::memory_order_relaxed);
+    const std::size_t dequeued =
+        dequeue_position_.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+template <typename T>
+bool MpmcQueue<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+std::size_t MpmcQueue<T>::round_up_(std::size_t capacity) {
+    std::size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+} // namespace rayalto::utils::misc
+
+#endif // RA_UTILS_RAUTILS_MISC_MPMC_QUEUE_H_
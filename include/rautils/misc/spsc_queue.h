@@ -0,0 +1,207 @@
+#ifndef RA_UTILS_RAUTILS_MISC_SPSC_QUEUE_H_
+#define RA_UTILS_RAUTILS_MISC_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rayalto::utils::misc {
+
+/**
+ * Bounded wait-free single-producer single-consumer queue. Each side keeps
+ * a cached copy of the other side's index and only reloads it when the
+ * ring looks full/empty, so most operations touch no shared cache line.
+ * Capacity is rounded up to a power of two. Exactly one thread may push
+ * and exactly one thread may pop.
+ * Example:
+ *      SpscQueue<Message> queue(1024);
+ *      // producer
+ *      queue.try_emplace("hello");
+ *      // consumer
+ *      queue.consume_all([](Message& message) { ... });
+ */
+template <typename T>
+class SpscQueue {
+public:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    explicit SpscQueue(const std::size_t& capacity);
+
+    SpscQueue() = delete;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue(SpscQueue&&) noexcept = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    SpscQueue& operator=(SpscQueue&&) noexcept = delete;
+
+    virtual ~SpscQueue();
+
+    /* producer */
+    // return false if the queue is full
+    bool try_push(const T& value);
+    bool try_push(T&& value);
+    // construct in place in the slot
+    template <typename... Args>
+    bool try_emplace(Args&&... args);
+
+    /* consumer */
+    // return false if the queue is empty
+    bool try_pop(T& value);
+    // the oldest value in place, nullptr if empty, valid until pop()
+    T* front();
+    // drop the oldest value, the queue must not be empty
+    void pop();
+    // call `consumer(T&)` on every value available now and drop them,
+    // return how many
+    template <typename Consumer>
+    std::size_t consume_all(Consumer&& consumer);
+
+    [[nodiscard]] const std::size_t& capacity() const;
+    // only a snapshot while the other side is active
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+protected:
+    using Slot = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    static std::size_t round_up_(std::size_t capacity);
+
+    T* slot_(const std::size_t& index);
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    const std::unique_ptr<Slot[]> slots_;
+
+    // written by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_ = 0;
+    // consumer's copy of tail_
+    std::size_t cached_tail_ = 0;
+
+    // written by the producer
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_ = 0;
+    // producer's copy of head_
+    std::size_t cached_head_ = 0;
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(const std::size_t& capacity) :
+    capacity_(round_up_(capacity)),
+    mask_(capacity_ - 1),
+    slots_(std::make_unique<Slot[]>(capacity_)) {}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        while (front() != nullptr) {
+            pop();
+        }
+    }
+}
+
+template <typename T>
+bool SpscQueue<T>::try_push(const T& value) {
+    return try_emplace(value);
+}
+
+template <typename T>
+bool SpscQueue<T>::try_push(T&& value) {
+    return try_emplace(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+bool SpscQueue<T>::try_emplace(Args&&... args) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == capacity_) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail - cached_head_ == capacity_) {
+            return false;
+        }
+    }
+    new (&slots_[tail & mask_]) T(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::try_pop(T& value) {
+    T* oldest = front();
+    if (oldest == nullptr) {
+        return false;
+    }
+    value = std::move(*oldest);
+    pop();
+    return true;
+}
+
+template <typename T>
+T* SpscQueue<T>::front() {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head == cached_tail_) {
+            return nullptr;
+        }
+    }
+    return slot_(head);
+}
+
+template <typename T>
+void SpscQueue<T>::pop() {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    slot_(head)->~T();
+    head_.store(head + 1, std::memory_order_release);
+}
+
+template <typename T>
+template <typename Consumer>
+std::size_t SpscQueue<T>::consume_all(Consumer&& consumer) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    const std::size_t count = cached_tail_ - head;
+    for (; head != cached_tail_; head++) {
+        T* value = slot_(head);
+        consumer(*value);
+        value->~T();
+        // hand every slot back right away so the producer keeps going
+        head_.store(head + 1, std::memory_order_release);
+    }
+    return count;
+}
+
+template <typename T>
+const std::size_t& SpscQueue<T>::capacity() const {
+    return capacity_;
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::size() const {
+    // head first, tail can only have grown since
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+}
+
+template <typename T>
+bool SpscQueue<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+std::size_t SpscQueue<T>::round_up_(std::size_t capacity) {
+    std::size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+template <typename T>
+T* SpscQueue<T>::slot_(const std::size_t& index) {
+    return std::launder(reinterpret_cast<T*>(&slots_[index & mask_]));
+}
+
+} // namespace rayalto::utils::misc
+
+#endif // RA_UTILS_RAUTILS_MISC_SPSC_QUEUE_H_
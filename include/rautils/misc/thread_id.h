@@ -3,8 +3,13 @@
 
 namespace rayalto::utils::misc {
 
+// small id (1, 2, ...) of the calling thread, ids of exited threads are
+// handed out again (smallest first) so they stay dense
 unsigned int thread_id();
 
+// largest id handed out so far, an upper bound for per-thread arrays
+unsigned int max_thread_id();
+
 } // namespace rayalto::utils::misc
 
 #endif // RA_UTILS_RAUTILS_MISC_THREAD_ID_H_
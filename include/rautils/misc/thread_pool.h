@@ -0,0 +1,173 @@
+#ifndef RA_UTILS_RAUTILS_MISC_THREAD_POOL_H_
+#define RA_UTILS_RAUTILS_MISC_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rayalto::utils::misc {
+
+/**
+ * Work-stealing thread pool. Every worker owns a Chase-Lev deque, tasks
+ * submitted from a worker go to its own deque (LIFO, cache friendly) and
+ * idle workers steal from the other end of the others'. Tasks from outside
+ * the pool go through a shared queue.
+ * Example:
+ *      ThreadPool& pool = ThreadPool::shared();
+ *      std::future<int> answer = pool.submit([]() { return 42; });
+ *      pool.parallel_for(0, data.size(), [&](std::size_t i) { ... });
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // `threads` workers (at least 1), each pinned to a CPU if `pin_threads`
+    explicit ThreadPool(const std::size_t& threads = default_threads(),
+                        const bool& pin_threads = false);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) noexcept = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+    // runs the tasks still queued, then joins the workers, so it must not be
+    // destroyed by one of its own tasks
+    virtual ~ThreadPool();
+
+    // process-wide pool with default_threads() workers, created on first use
+    static ThreadPool& shared();
+    // std::thread::hardware_concurrency(), at least 1
+    static std::size_t default_threads();
+
+    // run `task` without a way to wait for it
+    void post(Task&& task);
+
+    // run `function(args...)`, the future carries its result or exception
+    template <typename Function, typename... Args>
+    auto submit(Function&& function, Args&&... args)
+        -> std::future<std::invoke_result_t<Function, Args...>>;
+
+    // call `body(i)` for every i in [begin, end) in chunks of `grain`
+    // (0 to pick one), the calling thread helps and returns when all are done
+    template <typename Index, typename Body>
+    void parallel_for(const Index& begin,
+                      const Index& end,
+                      Body&& body,
+                      std::size_t grain = 0);
+
+    [[nodiscard]] std::size_t size() const;
+
+    // run one queued task on the calling thread, return false if none
+    bool run_pending_task();
+
+protected:
+    class WorkStealingDeque;
+    struct Worker;
+
+    void worker_loop_(const std::size_t& index);
+    // pop from own deque, then the shared queue, then steal
+    Task* take_task_(const std::size_t& index);
+    Task* steal_task_(const std::size_t& thief);
+    void push_task_(Task* task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex shared_mutex_;
+    std::deque<Task*> shared_queue_;
+
+    // queued and not yet taken tasks, workers sleep while it is 0
+    std::atomic<std::size_t> pending_ = 0;
+    std::atomic<std::size_t> sleepers_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> stopped_ = false;
+};
+
+template <typename Function, typename... Args>
+auto ThreadPool::submit(Function&& function, Args&&... args)
+    -> std::future<std::invoke_result_t<Function, Args...>> {
+    using Result = std::invoke_result_t<Function, Args...>;
+    // std::function needs a copyable target
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        [function = std::forward<Function>(function),
+         arguments = std::make_tuple(std::forward<Args>(args)...)]() mutable
+        -> Result { return std::apply(function, std::move(arguments)); });
+    std::future<Result> future = task->get_future();
+    post([task]() -> void { (*task)(); });
+    return future;
+}
+
+template <typename Index, typename Body>
+void ThreadPool::parallel_for(const Index& begin,
+                              const Index& end,
+                              Body&& body,
+                              std::size_t grain) {
+    if (!(begin < end)) {
+        return;
+    }
+    const auto total = static_cast<std::size_t>(end - begin);
+    if (grain == 0) {
+        // a few chunks per worker so stealing can even out the load
+        grain = std::max<std::size_t>(1, total / (size() * 4));
+    }
+    const std::size_t chunks = (total + grain - 1) / grain;
+
+    // guarded by done_mutex, so nothing touches it after we return
+    std::size_t remaining = chunks;
+    std::exception_ptr exception = nullptr;
+    std::mutex done_mutex;
+    std::condition_variable done;
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        post([&, chunk]() -> void {
+            const std::size_t first = chunk * grain;
+            const std::size_t last = std::min(total, first + grain);
+            std::exception_ptr thrown = nullptr;
+            try {
+                for (std::size_t i = first; i < last; i++) {
+                    body(static_cast<Index>(begin + static_cast<Index>(i)));
+                }
+            }
+            catch (...) {
+                thrown = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (thrown != nullptr && exception == nullptr) {
+                exception = thrown;
+            }
+            if (--remaining == 0) {
+                done.notify_all();
+            }
+        });
+    }
+    // help instead of blocking a thread that may be a worker itself
+    std::unique_lock<std::mutex> lock(done_mutex);
+    while (remaining != 0) {
+        lock.unlock();
+        const bool ran = run_pending_task();
+        lock.lock();
+        if (!ran && remaining != 0) {
+            done.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+    if (exception != nullptr) {
+        std::rethrow_exception(exception);
+    }
+}
+
+} // namespace rayalto::utils::misc
+
+#endif // RA_UTILS_RAUTILS_MISC_THREAD_POOL_H_
@@ -0,0 +1,144 @@
+#ifndef RA_UTILS_RAUTILS_MISC_THREAD_SLOTS_H_
+#define RA_UTILS_RAUTILS_MISC_THREAD_SLOTS_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "rautils/misc/thread_id.h"
+
+namespace rayalto::utils::misc {
+
+/**
+ * One cache-line aligned T per thread, indexed by thread_id(), so threads
+ * update their own slot without contention and a reader can visit all of
+ * them. Slots are allocated in segments on first use and never move. A new
+ * thread may get the slot (and the value) of an exited one since ids are
+ * recycled; beyond MAX_THREADS ids share slots, so T should tolerate
+ * concurrent access (e.g. be atomic) if that many threads may exist.
+ * Example:
+ *      ThreadSlots<std::atomic<int>> slots;
+ *      slots.local().fetch_add(1, std::memory_order_relaxed);
+ *      slots.for_each([&](std::atomic<int>& value) { sum += value; });
+ */
+template <typename T>
+class ThreadSlots {
+public:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+    static constexpr std::size_t SEGMENT_SIZE = 64;
+    static constexpr std::size_t MAX_SEGMENTS = 1024;
+    static constexpr std::size_t MAX_THREADS = SEGMENT_SIZE * MAX_SEGMENTS;
+
+    ThreadSlots() = default;
+    ThreadSlots(const ThreadSlots&) = delete;
+    ThreadSlots(ThreadSlots&&) noexcept = delete;
+    ThreadSlots& operator=(const ThreadSlots&) = delete;
+    ThreadSlots& operator=(ThreadSlots&&) noexcept = delete;
+
+    virtual ~ThreadSlots();
+
+    // the slot of the calling thread
+    T& local();
+
+    // call `function(T&)` on every slot allocated so far
+    template <typename Function>
+    void for_each(Function&& function);
+    template <typename Function>
+    void for_each(Function&& function) const;
+
+protected:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        T value {};
+    };
+
+    struct Segment {
+        std::array<Slot, SEGMENT_SIZE> slots;
+    };
+
+    std::array<std::atomic<Segment*>, MAX_SEGMENTS> segments_ {};
+};
+
+/**
+ * Counter sharded over ThreadSlots, add() is a relaxed increment of the
+ * caller's own cache line, value() sums all shards
+ */
+class ShardedCounter {
+public:
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter(ShardedCounter&&) noexcept = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(ShardedCounter&&) noexcept = delete;
+
+    virtual ~ShardedCounter() = default;
+
+    void add(const std::int64_t& delta = 1);
+
+    // sum of all shards, a snapshot while other threads are adding
+    [[nodiscard]] std::int64_t value() const;
+
+    // zero every shard, adds racing with it may survive
+    void reset();
+
+protected:
+    ThreadSlots<std::atomic<std::int64_t>> shards_;
+};
+
+template <typename T>
+ThreadSlots<T>::~ThreadSlots() {
+    for (std::atomic<Segment*>& segment : segments_) {
+        delete segment.load(std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+T& ThreadSlots<T>::local() {
+    const std::size_t index = (thread_id() - 1) % MAX_THREADS;
+    std::atomic<Segment*>& slot_segment = segments_[index / SEGMENT_SIZE];
+    Segment* segment = slot_segment.load(std::memory_order_acquire);
+    if (segment == nullptr) {
+        // first thread in this segment, racing threads keep the winner's
+        Segment* created = new Segment;
+        if (slot_segment.compare_exchange_strong(segment,
+                                                 created,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+            segment = created;
+        }
+        else {
+            delete created;
+        }
+    }
+    return segment->slots[index % SEGMENT_SIZE].value;
+}
+
+template <typename T>
+template <typename Function>
+void ThreadSlots<T>::for_each(Function&& function) {
+    for (std::atomic<Segment*>& slot_segment : segments_) {
+        Segment* segment = slot_segment.load(std::memory_order_acquire);
+        if (segment != nullptr) {
+            for (Slot& slot : segment->slots) {
+                function(slot.value);
+            }
+        }
+    }
+}
+
+template <typename T>
+template <typename Function>
+void ThreadSlots<T>::for_each(Function&& function) const {
+    for (const std::atomic<Segment*>& slot_segment : segments_) {
+        const Segment* segment = slot_segment.load(std::memory_order_acquire);
+        if (segment != nullptr) {
+            for (const Slot& slot : segment->slots) {
+                function(slot.value);
+            }
+        }
+    }
+}
+
+} // namespace rayalto::utils::misc
+
+#endif // RA_UTILS_RAUTILS_MISC_THREAD_SLOTS_H_
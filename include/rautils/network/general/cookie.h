@@ -9,12 +9,15 @@
 
 namespace rayalto::utils::network::general {
 
-class Cookie : public misc::DictHandler {
+// stored in a FlatMap, so base_container() is a misc::FlatDict
+class Cookie : public misc::FlatDictHandler {
 public:
     Cookie(
         std::initializer_list<std::pair<const std::string, std::string>> pairs);
     explicit Cookie(const misc::Dict& map);
     explicit Cookie(misc::Dict&& map);
+    explicit Cookie(const misc::FlatDict& map);
+    explicit Cookie(misc::FlatDict&& map);
     Cookie() = default;
     Cookie(const Cookie&);
     Cookie(Cookie&&) noexcept;
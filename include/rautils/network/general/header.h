@@ -1,12 +1,458 @@
 #ifndef RA_UTILS_RAUTILS_NETWORK_GENERAL_HEADER_H_
 #define RA_UTILS_RAUTILS_NETWORK_GENERAL_HEADER_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
 #include "rautils/misc/map_handler.h"
+#include "rautils/string/case_fold.h"
 
 namespace rayalto::utils::network::general {
 
-using Header = misc::DictIcHandler;
+// well-known header names, in the same order as HEADER_NAMES
+enum class HeaderId : std::uint8_t {
+    ACCEPT,
+    ACCEPT_CHARSET,
+    ACCEPT_ENCODING,
+    ACCEPT_LANGUAGE,
+    ACCEPT_RANGES,
+    ACCESS_CONTROL_ALLOW_CREDENTIALS,
+    ACCESS_CONTROL_ALLOW_HEADERS,
+    ACCESS_CONTROL_ALLOW_METHODS,
+    ACCESS_CONTROL_ALLOW_ORIGIN,
+    ACCESS_CONTROL_EXPOSE_HEADERS,
+    ACCESS_CONTROL_MAX_AGE,
+    ACCESS_CONTROL_REQUEST_HEADERS,
+    ACCESS_CONTROL_REQUEST_METHOD,
+    AGE,
+    ALLOW,
+    ALT_SVC,
+    AUTHORIZATION,
+    CACHE_CONTROL,
+    CONNECTION,
+    CONTENT_DISPOSITION,
+    CONTENT_ENCODING,
+    CONTENT_LANGUAGE,
+    CONTENT_LENGTH,
+    CONTENT_LOCATION,
+    CONTENT_RANGE,
+    CONTENT_SECURITY_POLICY,
+    CONTENT_TYPE,
+    COOKIE,
+    DATE,
+    ETAG,
+    EXPECT,
+    EXPIRES,
+    FORWARDED,
+    FROM,
+    HOST,
+    IF_MATCH,
+    IF_MODIFIED_SINCE,
+    IF_NONE_MATCH,
+    IF_RANGE,
+    IF_UNMODIFIED_SINCE,
+    KEEP_ALIVE,
+    LAST_MODIFIED,
+    LINK,
+    LOCATION,
+    MAX_FORWARDS,
+    ORIGIN,
+    PRAGMA,
+    PROXY_AUTHENTICATE,
+    PROXY_AUTHORIZATION,
+    RANGE,
+    REFERER,
+    RETRY_AFTER,
+    SEC_WEBSOCKET_ACCEPT,
+    SEC_WEBSOCKET_EXTENSIONS,
+    SEC_WEBSOCKET_KEY,
+    SEC_WEBSOCKET_PROTOCOL,
+    SEC_WEBSOCKET_VERSION,
+    SERVER,
+    SET_COOKIE,
+    STRICT_TRANSPORT_SECURITY,
+    TE,
+    TRAILER,
+    TRANSFER_ENCODING,
+    UPGRADE,
+    USER_AGENT,
+    VARY,
+    VIA,
+    WARNING,
+    WWW_AUTHENTICATE,
+    X_FORWARDED_FOR,
+    X_FORWARDED_HOST,
+    X_FORWARDED_PROTO,
+    X_REQUESTED_WITH,
+};
+
+inline constexpr std::array<std::string_view, 73> HEADER_NAMES {
+    "Accept",
+    "Accept-Charset",
+    "Accept-Encoding",
+    "Accept-Language",
+    "Accept-Ranges",
+    "Access-Control-Allow-Credentials",
+    "Access-Control-Allow-Headers",
+    "Access-Control-Allow-Methods",
+    "Access-Control-Allow-Origin",
+    "Access-Control-Expose-Headers",
+    "Access-Control-Max-Age",
+    "Access-Control-Request-Headers",
+    "Access-Control-Request-Method",
+    "Age",
+    "Allow",
+    "Alt-Svc",
+    "Authorization",
+    "Cache-Control",
+    "Connection",
+    "Content-Disposition",
+    "Content-Encoding",
+    "Content-Language",
+    "Content-Length",
+    "Content-Location",
+    "Content-Range",
+    "Content-Security-Policy",
+    "Content-Type",
+    "Cookie",
+    "Date",
+    "ETag",
+    "Expect",
+    "Expires",
+    "Forwarded",
+    "From",
+    "Host",
+    "If-Match",
+    "If-Modified-Since",
+    "If-None-Match",
+    "If-Range",
+    "If-Unmodified-Since",
+    "Keep-Alive",
+    "Last-Modified",
+    "Link",
+    "Location",
+    "Max-Forwards",
+    "Origin",
+    "Pragma",
+    "Proxy-Authenticate",
+    "Proxy-Authorization",
+    "Range",
+    "Referer",
+    "Retry-After",
+    "Sec-WebSocket-Accept",
+    "Sec-WebSocket-Extensions",
+    "Sec-WebSocket-Key",
+    "Sec-WebSocket-Protocol",
+    "Sec-WebSocket-Version",
+    "Server",
+    "Set-Cookie",
+    "Strict-Transport-Security",
+    "TE",
+    "Trailer",
+    "Transfer-Encoding",
+    "Upgrade",
+    "User-Agent",
+    "Vary",
+    "Via",
+    "Warning",
+    "WWW-Authenticate",
+    "X-Forwarded-For",
+    "X-Forwarded-Host",
+    "X-Forwarded-Proto",
+    "X-Requested-With",
+};
+
+static_assert(static_cast<std::size_t>(HeaderId::X_REQUESTED_WITH) + 1
+                  == HEADER_NAMES.size(),
+              "HeaderId and HEADER_NAMES are out of sync");
+
+namespace header_hash {
+
+// perfect hash of HEADER_NAMES: a seeded case insensitive FNV-1a, SEED is
+// one that gives every name its own slot (searching for it in a constexpr
+// loop costs every translation unit about a second, so it is hard coded)
+
+constexpr std::size_t SLOTS = 512;
+constexpr std::uint32_t SEED = 226;
+constexpr std::uint8_t EMPTY = 0xFF;
+
+constexpr std::uint32_t hash(const std::string_view& name,
+                             const std::uint32_t& seed) {
+    std::uint32_t hash = 2166136261U ^ seed;
+    for (const char& c : name) {
+        hash ^= static_cast<unsigned char>(string::to_lower_ascii(c));
+        hash *= 16777619U;
+    }
+    return hash ^ (hash >> 16);
+}
+
+struct Table {
+    bool perfect = true;
+    std::array<std::uint8_t, SLOTS> slots {};
+};
+
+constexpr Table build(const std::uint32_t& seed) {
+    Table table;
+    for (std::uint8_t& slot : table.slots) {
+        slot = EMPTY;
+    }
+    for (std::size_t id = 0; id < HEADER_NAMES.size(); id++) {
+        std::uint8_t& slot = table.slots[hash(HEADER_NAMES[id], seed) % SLOTS];
+        table.perfect = table.perfect && slot == EMPTY;
+        slot = static_cast<std::uint8_t>(id);
+    }
+    return table;
+}
+
+inline constexpr Table TABLE = build(SEED);
+
+static_assert(TABLE.perfect,
+              "HEADER_NAMES collide, find another SEED that build() accepts");
+
+constexpr bool equals_ic(const std::string_view& lv,
+                         const std::string_view& rv) {
+    if (lv.length() != rv.length()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lv.length(); i++) {
+        if (string::to_lower_ascii(lv[i]) != string::to_lower_ascii(rv[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace header_hash
+
+// canonical spelling of a well-known header
+constexpr std::string_view header_name(const HeaderId& id) {
+    return HEADER_NAMES[static_cast<std::size_t>(id)];
+}
+
+// id of a well-known header name (in any case), std::nullopt for others
+constexpr std::optional<HeaderId> header_id(const std::string_view& name) {
+    const std::uint8_t slot =
+        header_hash::TABLE.slots[header_hash::hash(name, header_hash::SEED)
+                                 % header_hash::SLOTS];
+    if (slot == header_hash::EMPTY
+        || !header_hash::equals_ic(HEADER_NAMES[slot], name)) {
+        return std::nullopt;
+    }
+    return static_cast<HeaderId>(slot);
+}
+
+static_assert(header_id("content-type") == HeaderId::CONTENT_TYPE);
+static_assert(!header_id("X-Custom").has_value());
+
+/**
+ * Case insensitive header map. Well-known names (HEADER_NAMES) are stored
+ * by id in a fixed array, so they never allocate a key and are found with
+ * one perfect hash probe, other names fall back to a FlatMap. Known
+ * headers keep their canonical spelling and come first when iterating.
+ * Iterators yield {std::string_view first; std::string& second;} proxies,
+ * so iterate with `const auto&` or `auto`. Headers are not kept in one
+ * container, base_container() builds a read-only copy.
+ * Example:
+ *      Header header {{"content-type", "text/plain"}, {"X-Foo", "bar"}};
+ *      header[HeaderId::USER_AGENT] = "ra-utils";
+ *      for (const auto& [name, value] : header) { ... }
+ */
+class Header {
+public:
+    template <bool Const>
+    class Iterator;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit Header(const misc::DictIC& map);
+    explicit Header(misc::DictIC&& map);
+    explicit Header(const misc::FlatDictIC& map);
+    explicit Header(misc::FlatDictIC&& map);
+    Header(std::initializer_list<std::pair<const std::string, std::string>>
+               pairs);
+
+    Header() = default;
+    Header(const Header&) = default;
+    Header(Header&&) noexcept = default;
+    Header& operator=(const Header&) = default;
+    Header& operator=(Header&&) noexcept = default;
+
+    virtual ~Header() = default;
+
+    std::string& operator[](const std::string_view& name);
+    std::string& operator[](const HeaderId& id);
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+
+    void clear();
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    iterator find(const std::string_view& name);
+    const_iterator find(const std::string_view& name) const;
+    iterator find(const HeaderId& id);
+    const_iterator find(const HeaderId& id) const;
+
+    iterator erase(const const_iterator& pos);
+    iterator erase(const const_iterator& first, const const_iterator& last);
+
+    std::pair<iterator, bool> insert(
+        const std::pair<std::string, std::string>& item);
+    std::pair<iterator, bool> insert(
+        std::pair<std::string, std::string>&& item);
+    // `hint` is ignored, every header has a fixed place
+    iterator insert(const const_iterator& hint,
+                    const std::pair<std::string, std::string>& item);
+    iterator insert(const const_iterator& hint,
+                    std::pair<std::string, std::string>&& item);
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+    void insert(
+        std::initializer_list<std::pair<const std::string, std::string>> items);
+
+    // test whether a header exists
+    [[nodiscard]] bool exists(const std::string_view& name) const;
+    [[nodiscard]] bool exists(const HeaderId& id) const;
+
+    // try to remove a header, return false if it does not exists
+    bool remove(const std::string_view& name);
+    bool remove(const HeaderId& id);
+    // try to remove headers, return the amount actually removed
+    std::size_t remove(std::initializer_list<std::string_view> names);
+
+    // try to add a header, return false if it already exists
+    bool add(const std::pair<std::string, std::string>& item);
+    bool add(std::pair<std::string, std::string>&& item);
+    // try to add headers, return the amount actually added
+    std::size_t add(
+        std::initializer_list<std::pair<std::string, std::string>> items);
+
+    // try to update/add a header, return false if a same one already exists
+    bool update(const std::pair<std::string, std::string>& item);
+    bool update(std::pair<std::string, std::string>&& item);
+    // try to update/add headers, return the amount actually updated/added
+    std::size_t update(
+        std::initializer_list<std::pair<std::string, std::string>> items);
+
+    // every header in one map. a copy, so it is const to not take writes
+    // that would be lost
+    [[nodiscard]] const misc::FlatDictIC base_container() const;
+
+protected:
+    static constexpr std::size_t KNOWN_COUNT = HEADER_NAMES.size();
+    static constexpr std::size_t WORD_BITS = 64;
+    static constexpr std::size_t WORD_COUNT =
+        (KNOWN_COUNT + WORD_BITS - 1) / WORD_BITS;
+
+    [[nodiscard]] bool has_(const std::size_t& index) const;
+    void set_(const std::size_t& index);
+    void unset_(const std::size_t& index);
+    // first known header at or after `index`, KNOWN_COUNT if none
+    [[nodiscard]] std::size_t next_known_(std::size_t index) const;
+
+    // values of known headers, by id
+    std::array<std::string, KNOWN_COUNT> known_;
+    // which known headers are set
+    std::array<std::uint64_t, WORD_COUNT> present_ {};
+    std::size_t known_count_ = 0;
+    misc::FlatDictIC others_;
+};
+
+template <bool Const>
+class Header::Iterator {
+public:
+    using HeaderType = std::conditional_t<Const, const Header, Header>;
+    using ValueType = std::conditional_t<Const, const std::string, std::string>;
+
+    struct Item {
+        std::string_view first;
+        ValueType& second;
+    };
+
+    struct Pointer {
+        Item item;
+        const Item* operator->() const {
+            return &item;
+        }
+    };
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Item;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Pointer;
+    using reference = Item;
+
+    Iterator() = default;
+    Iterator(HeaderType* header, const std::size_t& index) :
+        header_(header), index_(index) {}
+    // iterator -> const_iterator
+    template <bool OtherConst,
+              typename = std::enable_if_t<Const && !OtherConst>>
+    Iterator(const Iterator<OtherConst>& other) :
+        header_(other.header_), index_(other.index_) {}
+
+    Item operator*() const {
+        if (index_ < KNOWN_COUNT) {
+            return {HEADER_NAMES[index_], header_->known_[index_]};
+        }
+        auto& other = header_->others_.begin()[index_ - KNOWN_COUNT];
+        return {other.first, other.second};
+    }
+
+    Pointer operator->() const {
+        return {**this};
+    }
+
+    Iterator& operator++() {
+        index_ = index_ < KNOWN_COUNT ? header_->next_known_(index_ + 1)
+                                      : index_ + 1;
+        return *this;
+    }
+
+    Iterator operator++(int) {
+        Iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool operator==(const Iterator& other) const {
+        return index_ == other.index_;
+    }
+
+    bool operator!=(const Iterator& other) const {
+        return index_ != other.index_;
+    }
+
+protected:
+    friend class Header;
+    friend class Iterator<!Const>;
+
+    HeaderType* header_ = nullptr;
+    // < KNOWN_COUNT: id of a known header, otherwise KNOWN_COUNT + index in
+    // others_
+    std::size_t index_ = 0;
+};
+
+template <typename InputIt>
+void Header::insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+        insert({std::string((*first).first), std::string((*first).second)});
+    }
+}
 
 } // namespace rayalto::utils::network::general
 
-#endif // RA_UTILS_RAUTILS_NETWORK_GENERAL_H_
+#endif // RA_UTILS_RAUTILS_NETWORK_GENERAL_HEADER_H_
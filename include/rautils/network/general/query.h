@@ -5,7 +5,9 @@
 
 namespace rayalto::utils::network::general {
 
-using Query = misc::DictHandler;
+// stored in a FlatMap, so base_container() is a misc::FlatDict rather than
+// the std::map of a DictHandler
+using Query = misc::FlatDictHandler;
 
 } // namespace rayalto::utils::network::general
 
@@ -2,5 +2,7 @@
 #define RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_H_
 
 #include "rautils/network/websocket/client.h"
+#include "rautils/network/websocket/recording.h"
+#include "rautils/network/websocket/replay_server.h"
 
 #endif // RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_H_
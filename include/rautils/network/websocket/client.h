@@ -1,11 +1,14 @@
 #ifndef RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_CLIENT_H_
 #define RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_CLIENT_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "rautils/misc/histogram.h"
 #include "rautils/network/general/cookie.h"
 #include "rautils/network/general/header.h"
 #include "rautils/network/general/url.h"
@@ -19,11 +22,36 @@ public:
     // have to use ClientImpl in lws_callback, so it cannot be private/protected
     class ClientImpl;
 
+    struct DeflateSetting;
+    struct Fragment;
+    struct KeepaliveSetting;
+    struct ReconnectSetting;
+    struct Stats;
+
     using ErrorCallback = std::function<void(Client&, const std::string&)>;
     using EstablishCallback = std::function<void(Client&)>;
     using ReceiveCallback = std::function<void(Client&, const Message&)>;
+    using FragmentCallback = std::function<void(
+        Client&, const Fragment&, bool is_first, bool is_final)>;
     using CloseCallback =
         std::function<void(Client&, const CloseStatus&, const std::string&)>;
+    // returns messages (e.g. subscriptions) to resend after reconnecting
+    using ReconnectCallback = std::function<std::vector<Message>(Client&)>;
+    // fills at most `length` bytes into `buffer` and returns the amount, sets
+    // `final` along with the last chunk. returning 0 without `final` means
+    // no data yet: nothing is sent and the callback is asked again after
+    // 1, 2, 4 ... up to 64 ms
+    using StreamCallback = std::function<std::size_t(
+        Client&, unsigned char* buffer, std::size_t length, bool& final)>;
+
+    // runs a task somewhere, e.g. on a thread pool
+    using Executor = std::function<void(std::function<void()>)>;
+
+    static const std::size_t DEFAULT_FRAGMENT_SIZE;
+
+    // an Executor backed by a misc::ThreadPool of `threads` workers, which
+    // stays alive as long as a copy of it does, clients may share one
+    [[nodiscard]] static Executor thread_pool(const std::size_t& threads);
 
     Client();
     Client(const Client&) = delete;
@@ -31,6 +59,8 @@ public:
     Client& operator=(const Client&) = delete;
     Client& operator=(Client&&) noexcept;
 
+    // disconnects, may be called from a callback of this client, which is
+    // then the last one it runs
     virtual ~Client();
 
     Client& connect();
@@ -46,6 +76,15 @@ public:
     Client& disconnect(const std::string& message,
                        const std::uint16_t& close_status);
 
+    // close all clients in parallel, return after all of them are stopped and
+    // their on_close ran, like disconnect()
+    static void disconnect_all(const std::vector<Client*>& clients);
+    static void disconnect_all(const std::vector<Client*>& clients,
+                               const std::string& message,
+                               const CloseStatus& close_status =
+                                   static_cast<CloseStatus>(
+                                       CloseStatus::NORMAL));
+
     // if connection was established
     [[nodiscard]] bool connected() const;
 
@@ -79,6 +118,26 @@ public:
     Client& cookie(general::Cookie&& cookie);
     Client& cookie(std::nullptr_t);
 
+    // permessage-deflate extension (RFC 7692), disabled if nullptr (default)
+    const std::unique_ptr<DeflateSetting>& deflate_setting();
+    Client& deflate_setting(const DeflateSetting& deflate_setting);
+    Client& deflate_setting(std::nullptr_t);
+
+    // max payload of a single frame, larger messages are split into
+    // continuation frames, 0 to always send a message in one frame
+    [[nodiscard]] const std::size_t& fragment_size() const;
+    Client& fragment_size(const std::size_t& fragment_size);
+
+    // ping/pong keepalive, disabled if nullptr (default)
+    const std::unique_ptr<KeepaliveSetting>& keepalive_setting();
+    Client& keepalive_setting(const KeepaliveSetting& keepalive_setting);
+    Client& keepalive_setting(std::nullptr_t);
+
+    // reconnect after unexpected closure, disabled if nullptr (default)
+    const std::unique_ptr<ReconnectSetting>& reconnect_setting();
+    Client& reconnect_setting(const ReconnectSetting& reconnect_setting);
+    Client& reconnect_setting(std::nullptr_t);
+
     // callback on connection error
     const std::unique_ptr<ErrorCallback>& on_error();
     Client& on_error(const ErrorCallback& callback);
@@ -97,18 +156,155 @@ public:
     Client& on_receive(ReceiveCallback&& callback);
     Client& on_receive(std::nullptr_t);
 
+    // callback on every piece of a message as it arrives, before it is
+    // complete. messages are only buffered for on_receive if it is set, so
+    // with on_receive unset memory stays constant however large they get
+    const std::unique_ptr<FragmentCallback>& on_fragment();
+    Client& on_fragment(const FragmentCallback& callback);
+    Client& on_fragment(FragmentCallback&& callback);
+    Client& on_fragment(std::nullptr_t);
+
     // callback on connection closure
     const std::unique_ptr<CloseCallback>& on_close();
     Client& on_close(const CloseCallback& callback);
     Client& on_close(CloseCallback&& callback);
     Client& on_close(std::nullptr_t);
 
+    // callback on re-establishment after an automatic reconnect, messages
+    // it returns are sent before those still queued
+    const std::unique_ptr<ReconnectCallback>& on_reconnect();
+    Client& on_reconnect(const ReconnectCallback& callback);
+    Client& on_reconnect(ReconnectCallback&& callback);
+    Client& on_reconnect(std::nullptr_t);
+
+    // run on_error, on_establish, on_fragment, on_receive and on_close on
+    // `executor` instead of the service thread, one at a time and in order
+    // per client, so slow handlers do not hold up network io. on_reconnect
+    // and stream callbacks still run on the service thread since their
+    // results are needed there. set before connect(), and do not destroy the
+    // client from a callback while it is set. nullptr (default) to run
+    // callbacks inline
+    const std::unique_ptr<Executor>& executor();
+    Client& executor(const Executor& executor);
+    Client& executor(Executor&& executor);
+    Client& executor(std::nullptr_t);
+
     // send message to server
     Client& send(const Message& message);
     Client& send(Message&& message);
 
+    // send a message whose payload is pulled chunk by chunk from `callback`
+    // in the service thread, one chunk per frame, so it never has to be held
+    // in memory as a whole. a stream interrupted by a reconnect is dropped
+    Client& send_stream(const Message::Type& type,
+                        const StreamCallback& callback);
+    Client& send_stream(const Message::Type& type, StreamCallback&& callback);
+
+    // traffic statistics, safe to read from any thread
+    [[nodiscard]] Stats stats() const;
+
+    // round-trip time of keepalive pings in microseconds
+    [[nodiscard]] const misc::Histogram& rtt() const;
+
+    // nanoseconds from an event on the service thread until its callback
+    // starts to run
+    [[nodiscard]] const misc::Histogram& delivery_latency() const;
+
 protected:
-    std::unique_ptr<ClientImpl> impl_;
+    // shared with the service thread, which may outlive the Client
+    std::shared_ptr<ClientImpl> impl_;
+};
+
+struct Client::DeflateSetting {
+    // max LZ77 window bits (8 ~ 15) the server may use, 0 for no limit
+    std::uint8_t server_max_window_bits = 0;
+    // max LZ77 window bits (8 ~ 15) the client may use, 0 for no limit
+    std::uint8_t client_max_window_bits = 0;
+    // ask the server to reset its compression context for each message
+    bool server_no_context_takeover = false;
+    // reset the local compression context for each message
+    bool client_no_context_takeover = false;
+    // messages shorter than this are sent without compression
+    std::size_t min_length = 64;
+};
+
+struct Client::KeepaliveSetting {
+    // ping the server when the connection has been idle this long, in
+    // milliseconds, also the interval of round-trip time samples
+    std::uint32_t ping_interval = 30000;
+    // close the connection if the pong does not arrive in time, in
+    // milliseconds
+    std::uint32_t pong_timeout = 10000;
+};
+
+struct Client::ReconnectSetting {
+    // delay before the first attempt, in milliseconds
+    std::uint32_t initial_delay = 100;
+    // upper bound of the delay, in milliseconds
+    std::uint32_t max_delay = 30000;
+    // the delay grows by this factor after each failed attempt
+    double multiplier = 2.0;
+    // each delay is randomly shortened by up to this fraction (0 ~ 1), so
+    // that many clients losing the same server do not come back at once
+    double jitter = 0.5;
+    // give up after this many consecutive failed attempts, 0 for never
+    std::uint32_t max_attempts = 0;
+    // keep messages not sent yet for the next connection
+    bool retain_queue = true;
+};
+
+// a piece of an incoming message, only valid during the callback
+struct Client::Fragment {
+    Message::Type type = Message::Type::TEXT;
+    const unsigned char* data = nullptr;
+    std::size_t length = 0;
+};
+
+struct Client::Stats {
+    // data frames and their payload bytes as handed to/from libwebsockets
+    std::uint64_t frames_in = 0;
+    std::uint64_t frames_out = 0;
+    std::uint64_t bytes_in = 0;
+    std::uint64_t bytes_out = 0;
+    // complete messages
+    std::uint64_t messages_in = 0;
+    std::uint64_t messages_out = 0;
+
+    // messages waiting in the send queue, not counting the one being sent
+    std::uint64_t queued_messages = 0;
+    // payload bytes of those messages (0 for streams), now and at most
+    std::uint64_t queued_bytes = 0;
+    std::uint64_t peak_queued_bytes = 0;
+
+    // LWS_CALLBACK_CLIENT_WRITEABLE served by the service thread
+    std::uint64_t writable_callbacks = 0;
+    // frames the socket did not take at once, libwebsockets buffered the rest
+    std::uint64_t partial_writes = 0;
+
+    // calls to user callbacks and the total time spent in them
+    std::uint64_t callbacks = 0;
+    std::uint64_t callback_nanoseconds = 0;
+
+    // wire bytes of compressed messages received/sent
+    std::uint64_t compressed_bytes_in = 0;
+    std::uint64_t compressed_bytes_out = 0;
+    // payload bytes of the same messages before compression
+    std::uint64_t original_bytes_in = 0;
+    std::uint64_t original_bytes_out = 0;
+
+    // connections closed or failed without disconnect() being called
+    std::uint64_t unexpected_closes = 0;
+    // automatic reconnect attempts, successful or not
+    std::uint64_t reconnect_attempts = 0;
+    // connections re-established by automatic reconnect
+    std::uint64_t reconnects = 0;
+
+    // connections closed because the server did not answer a ping
+    std::uint64_t pong_timeouts = 0;
+
+    // compressed / original, 1.0 if nothing was compressed
+    [[nodiscard]] double compression_ratio_in() const;
+    [[nodiscard]] double compression_ratio_out() const;
 };
 
 } // namespace rayalto::utils::network::websocket
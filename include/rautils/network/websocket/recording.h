@@ -0,0 +1,101 @@
+#ifndef RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_RECORDING_H_
+#define RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_RECORDING_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "rautils/network/websocket/message.h"
+
+namespace rayalto::utils::network::websocket {
+
+/**
+ * Inbound messages with their arrival time, can be saved to / loaded from a
+ * compact binary file and streamed back by ReplayServer
+ *
+ * File layout:
+ *     "RAWSREC" 0x01, then per message:
+ *     varint  microseconds since the previous message
+ *     uint8   Message::Type
+ *     varint  payload length
+ *     bytes   payload
+ */
+class Recording {
+public:
+    struct Entry {
+        // microseconds since the first message
+        std::uint64_t timestamp = 0;
+        Message message;
+    };
+
+    Recording() = default;
+    Recording(const Recording&) = default;
+    Recording(Recording&&) noexcept = default;
+    Recording& operator=(const Recording&) = default;
+    Recording& operator=(Recording&&) noexcept = default;
+
+    virtual ~Recording() = default;
+
+    // throws exceptions::Exception if the file is unreadable or malformed
+    static Recording load(const std::string& path);
+    // throws exceptions::Exception if the file is unwritable
+    void save(const std::string& path) const;
+
+    [[nodiscard]] const std::vector<Entry>& entries() const;
+    std::vector<Entry>& entries();
+
+    // timestamps must not decrease
+    Recording& add(const std::uint64_t& timestamp, const Message& message);
+    Recording& add(const std::uint64_t& timestamp, Message&& message);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+    // timestamp of the last message in microseconds
+    [[nodiscard]] std::uint64_t duration() const;
+
+protected:
+    std::vector<Entry> entries_;
+};
+
+/**
+ * Appends messages to a recording file as they arrive, e.g.
+ *     client.on_receive([&](Client&, const Message& message) {
+ *         recorder.record(message);
+ *     });
+ * not thread-safe, record from one thread (like the service thread)
+ */
+class Recorder {
+public:
+    // throws exceptions::Exception if the file is unwritable
+    explicit Recorder(const std::string& path);
+
+    Recorder() = delete;
+    Recorder(const Recorder&) = delete;
+    Recorder(Recorder&&) noexcept = default;
+    Recorder& operator=(const Recorder&) = delete;
+    Recorder& operator=(Recorder&&) noexcept = default;
+
+    virtual ~Recorder() = default;
+
+    // timestamped relative to the first recorded message
+    Recorder& record(const Message& message);
+
+    Recorder& flush();
+
+    // messages recorded so far
+    [[nodiscard]] const std::size_t& count() const;
+
+protected:
+    std::ofstream file_;
+    std::chrono::steady_clock::time_point start_;
+    std::uint64_t last_timestamp_ = 0;
+    std::size_t count_ = 0;
+};
+
+} // namespace rayalto::utils::network::websocket
+
+#endif // RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_RECORDING_H_
@@ -0,0 +1,58 @@
+#ifndef RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_REPLAY_SERVER_H_
+#define RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_REPLAY_SERVER_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "rautils/network/websocket/recording.h"
+
+namespace rayalto::utils::network::websocket {
+
+/**
+ * Local websocket server streaming a Recording to every client that
+ * connects, then closing the connection normally. Lets client-side message
+ * handling be benchmarked without a live server:
+ *     ReplayServer server(Recording::load("feed.rec"));
+ *     server.speed(0).start(7681);
+ *     client.connect(Url("ws://127.0.0.1:7681"));
+ */
+class ReplayServer {
+public:
+    // have to use ReplayServerImpl in lws_callback, so it cannot be private
+    class ReplayServerImpl;
+
+    explicit ReplayServer(const Recording& recording);
+    explicit ReplayServer(Recording&& recording);
+
+    ReplayServer() = delete;
+    ReplayServer(const ReplayServer&) = delete;
+    ReplayServer(ReplayServer&&) noexcept = default;
+    ReplayServer& operator=(const ReplayServer&) = delete;
+    ReplayServer& operator=(ReplayServer&&) noexcept = default;
+
+    virtual ~ReplayServer();
+
+    // playback speed, 1 for the recorded pace, N for N times faster, 0 for
+    // as fast as the connection takes (default). Atomic, so it may be
+    // changed from any thread while running(), the next message due picks
+    // it up
+    [[nodiscard]] double speed() const;
+    ReplayServer& speed(const double& speed);
+
+    // listen on 127.0.0.1:port in a service thread, throws
+    // exceptions::Exception if the server cannot be created
+    ReplayServer& start(const std::uint16_t& port);
+    ReplayServer& stop();
+
+    [[nodiscard]] bool running() const;
+
+    // messages sent to all clients so far, safe to read from any thread
+    [[nodiscard]] std::uint64_t sent() const;
+
+protected:
+    std::unique_ptr<ReplayServerImpl> impl_;
+};
+
+} // namespace rayalto::utils::network::websocket
+
+#endif // RA_UTILS_RAUTILS_NETWORK_WEBSOCKET_REPLAY_SERVER_H_
@@ -0,0 +1,29 @@
+#ifndef RA_UTILS_RAUTILS_STRING_CASE_FOLD_H_
+#define RA_UTILS_RAUTILS_STRING_CASE_FOLD_H_
+
+#include <cstddef>
+#include <string_view>
+
+namespace rayalto::utils::string {
+
+// ASCII-only case folding, independent of the current locale, which is what
+// header names, schemes, mime types etc. need. Comparisons run 32/16/8 bytes
+// at a time (AVX2 when the cpu has it, SSE2, or plain 64-bit words)
+
+constexpr char to_lower_ascii(const char& c) noexcept {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// case insensitive equality
+bool equals_ic(const std::string_view& lv, const std::string_view& rv) noexcept;
+
+// case insensitive strcmp: < 0, 0 or > 0 as lv sorts before, same as or
+// after rv
+int casecmp(const std::string_view& lv, const std::string_view& rv) noexcept;
+
+// case insensitive hash: equals_ic(a, b) implies hash_ic(a) == hash_ic(b)
+std::size_t hash_ic(const std::string_view& str) noexcept;
+
+} // namespace rayalto::utils::string
+
+#endif // RA_UTILS_RAUTILS_STRING_CASE_FOLD_H_
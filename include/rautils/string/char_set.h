@@ -0,0 +1,148 @@
+#ifndef RA_UTILS_RAUTILS_STRING_CHAR_SET_H_
+#define RA_UTILS_RAUTILS_STRING_CHAR_SET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rayalto::utils::string {
+
+/**
+ * A set of bytes as a 256-bit table, testing a character is a shift and a
+ * mask. Everything is constexpr, so sets known up front cost nothing at run
+ * time
+ *
+ * Example:
+ *
+ * constexpr string::CharSet quotes {"\"'"};
+ * std::string_view value = string::strip_view(raw, quotes | string::SPACES);
+ */
+class CharSet {
+public:
+    constexpr CharSet() noexcept = default;
+    constexpr explicit CharSet(const std::string_view& chars) noexcept;
+    constexpr CharSet(const CharSet&) noexcept = default;
+    constexpr CharSet(CharSet&&) noexcept = default;
+    constexpr CharSet& operator=(const CharSet&) noexcept = default;
+    constexpr CharSet& operator=(CharSet&&) noexcept = default;
+
+    ~CharSet() = default;
+
+    // every character in [first, last]
+    static constexpr CharSet range(const char& first,
+                                   const char& last) noexcept;
+
+    constexpr bool contains(const char& c) const noexcept;
+    constexpr bool empty() const noexcept;
+    constexpr std::size_t size() const noexcept;
+
+    constexpr CharSet& insert(const char& c) noexcept;
+    constexpr CharSet& erase(const char& c) noexcept;
+
+    // union, intersection and complement
+    constexpr CharSet operator|(const CharSet& other) const noexcept;
+    constexpr CharSet operator&(const CharSet& other) const noexcept;
+    constexpr CharSet operator~() const noexcept;
+
+    constexpr bool operator==(const CharSet& other) const noexcept;
+    constexpr bool operator!=(const CharSet& other) const noexcept;
+
+protected:
+    std::uint64_t words_[4] {};
+};
+
+constexpr CharSet::CharSet(const std::string_view& chars) noexcept {
+    for (const char& c : chars) {
+        insert(c);
+    }
+}
+
+constexpr CharSet CharSet::range(const char& first, const char& last) noexcept {
+    CharSet set;
+    for (unsigned int c = static_cast<unsigned char>(first);
+         c <= static_cast<unsigned char>(last);
+         c++) {
+        set.insert(static_cast<char>(c));
+    }
+    return set;
+}
+
+constexpr bool CharSet::contains(const char& c) const noexcept {
+    const unsigned char byte = static_cast<unsigned char>(c);
+    return ((words_[byte >> 6] >> (byte & 63)) & 1U) != 0;
+}
+
+constexpr bool CharSet::empty() const noexcept {
+    return (words_[0] | words_[1] | words_[2] | words_[3]) == 0;
+}
+
+constexpr std::size_t CharSet::size() const noexcept {
+    std::size_t count = 0;
+    for (const std::uint64_t& word : words_) {
+        for (std::uint64_t bits = word; bits != 0; bits &= bits - 1) {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+constexpr CharSet& CharSet::insert(const char& c) noexcept {
+    const unsigned char byte = static_cast<unsigned char>(c);
+    words_[byte >> 6] |= std::uint64_t {1} << (byte & 63);
+    return *this;
+}
+
+constexpr CharSet& CharSet::erase(const char& c) noexcept {
+    const unsigned char byte = static_cast<unsigned char>(c);
+    words_[byte >> 6] &= ~(std::uint64_t {1} << (byte & 63));
+    return *this;
+}
+
+constexpr CharSet CharSet::operator|(const CharSet& other) const noexcept {
+    CharSet set;
+    for (std::size_t i = 0; i < 4; i++) {
+        set.words_[i] = words_[i] | other.words_[i];
+    }
+    return set;
+}
+
+constexpr CharSet CharSet::operator&(const CharSet& other) const noexcept {
+    CharSet set;
+    for (std::size_t i = 0; i < 4; i++) {
+        set.words_[i] = words_[i] & other.words_[i];
+    }
+    return set;
+}
+
+constexpr CharSet CharSet::operator~() const noexcept {
+    CharSet set;
+    for (std::size_t i = 0; i < 4; i++) {
+        set.words_[i] = ~words_[i];
+    }
+    return set;
+}
+
+constexpr bool CharSet::operator==(const CharSet& other) const noexcept {
+    for (std::size_t i = 0; i < 4; i++) {
+        if (words_[i] != other.words_[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool CharSet::operator!=(const CharSet& other) const noexcept {
+    return !(*this == other);
+}
+
+// what std::isspace() matches in the "C" locale
+inline constexpr CharSet SPACES {" \t\n\v\f\r"};
+inline constexpr CharSet DIGITS = CharSet::range('0', '9');
+inline constexpr CharSet HEX_DIGITS =
+    DIGITS | CharSet::range('a', 'f') | CharSet::range('A', 'F');
+inline constexpr CharSet ALPHAS =
+    CharSet::range('a', 'z') | CharSet::range('A', 'Z');
+
+} // namespace rayalto::utils::string
+
+#endif // RA_UTILS_RAUTILS_STRING_CHAR_SET_H_
@@ -0,0 +1,27 @@
+#ifndef RA_UTILS_RAUTILS_STRING_HEX_H_
+#define RA_UTILS_RAUTILS_STRING_HEX_H_
+
+#include <cstddef>
+
+namespace rayalto::utils::string {
+
+// hex kernels writing into caller memory, 32/16 bytes at a time with AVX2 or
+// SSSE3 when the cpu has them, a lookup table otherwise. hex_string() and
+// parse_hex() in strtool.h are built on these
+
+// encode `length` bytes into 2 * length characters at `out` (no '\0')
+void hex_encode(const unsigned char* data,
+                const std::size_t& length,
+                char* out,
+                const bool& upper_case = false) noexcept;
+
+// decode `length` characters into (length + 1) / 2 bytes at `out`, return
+// the amount of bytes written. An odd last character is a high nibble,
+// characters that are not hex digits decode as 0xf
+std::size_t hex_decode(const char* hex,
+                       const std::size_t& length,
+                       unsigned char* out) noexcept;
+
+} // namespace rayalto::utils::string
+
+#endif // RA_UTILS_RAUTILS_STRING_HEX_H_
@@ -0,0 +1,85 @@
+#ifndef RA_UTILS_RAUTILS_STRING_RANDOM_STRING_H_
+#define RA_UTILS_RAUTILS_STRING_RANDOM_STRING_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace rayalto::utils::string {
+
+/**
+ * Random strings over an alphabet of 1 to 65536 characters, every character
+ * equally likely. Random bytes are drawn in blocks and mapped through a
+ * lookup table, bytes that would bias the result are rejected without a
+ * branch. Not thread safe, use one per thread
+ *
+ * Source::FAST is xoshiro256** seeded from std::random_device: ids, test
+ * data, multipart boundaries. Source::SECURE draws from the OpenSSL DRBG:
+ * nonces, tokens, anything an attacker must not predict
+ *
+ * Example:
+ *
+ * string::RandomString random {"0123456789abcdef"};
+ * std::string id = random(32);
+ * char nonce[16];
+ * string::RandomString {string::RandomString::ALPHANUMERIC,
+ *                       string::RandomString::Source::SECURE}
+ *     .fill(nonce, sizeof(nonce));
+ */
+class RandomString {
+public:
+    enum class Source : std::uint8_t { FAST, SECURE };
+
+    static constexpr std::string_view ALPHANUMERIC =
+        "0123456789"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        "abcdefghijklmnopqrstuvwxyz";
+
+    // throws exceptions::Exception if `alphabet` is empty or longer than
+    // 65536 characters
+    explicit RandomString(const std::string_view& alphabet = ALPHANUMERIC,
+                          const Source& source = Source::FAST);
+    // Source::FAST with a fixed seed, the same seed gives the same strings
+    RandomString(const std::string_view& alphabet, const std::uint64_t& seed);
+    RandomString(const RandomString&) = default;
+    RandomString(RandomString&&) noexcept = default;
+    RandomString& operator=(const RandomString&) = default;
+    RandomString& operator=(RandomString&&) noexcept = default;
+
+    virtual ~RandomString() = default;
+
+    std::string operator()(const std::size_t& length);
+
+    // write `length` random characters to `out` (no '\0')
+    void fill(char* out, const std::size_t& length);
+
+    const std::string& alphabet() const noexcept;
+    const Source& source() const noexcept;
+
+protected:
+    static constexpr std::size_t BUFFER_SIZE = 256;
+
+    std::string alphabet_;
+    Source source_;
+    // alphabet sizes up to 256 take one random byte per character, larger
+    // ones two
+    bool wide_ = false;
+    // random values >= limit_ are rejected, it is the largest multiple of
+    // the alphabet size that fits
+    std::uint32_t limit_ = 0;
+    // byte -> character, valid below limit_
+    std::array<char, 256> table_ {};
+    std::uint64_t state_[4] {};
+    // random bytes not used yet are buffer_[position_, BUFFER_SIZE)
+    std::array<unsigned char, BUFFER_SIZE> buffer_ {};
+    std::size_t position_ = BUFFER_SIZE;
+
+    void init_();
+    void refill_();
+};
+
+} // namespace rayalto::utils::string
+
+#endif // RA_UTILS_RAUTILS_STRING_RANDOM_STRING_H_
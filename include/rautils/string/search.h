@@ -0,0 +1,131 @@
+#ifndef RA_UTILS_RAUTILS_STRING_SEARCH_H_
+#define RA_UTILS_RAUTILS_STRING_SEARCH_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rayalto::utils::string {
+
+// substring search: index of the first `needle` in `haystack` at or after
+// `pos`, std::string_view::npos if there is none. Candidates are filtered on
+// the first and last byte of the needle 32/16 bytes at a time (AVX2 when the
+// cpu has it, SSE2, or memchr) and confirmed with memcmp. When too many
+// candidates turn out false (periodic text like "aaaa...") the rest is
+// searched with Two-Way, so the worst case stays linear
+std::size_t find_first(const std::string_view& haystack,
+                       const std::string_view& needle,
+                       const std::size_t& pos = 0) noexcept;
+
+/**
+ * Aho-Corasick automaton: finds every occurrence of many patterns in one pass
+ * over the text, whatever the number of patterns. Bytes are mapped to the
+ * classes that appear in the patterns, so each state is a row of only that
+ * many transitions. Empty patterns never match
+ *
+ * Example:
+ *
+ * string::AhoCorasick markers {{"<script", "javascript:", "onerror="}, true};
+ * markers.for_each(body, [](const string::AhoCorasick::Match& match) {
+ *     std::cout << match.pattern << " at " << match.position << std::endl;
+ * });
+ */
+class AhoCorasick {
+public:
+    struct Match {
+        // index of the pattern as given to the constructor
+        std::size_t pattern;
+        // index of the first byte of the occurrence in the text
+        std::size_t position;
+    };
+
+    AhoCorasick(std::initializer_list<std::string_view> patterns,
+                const bool& case_insensitive = false);
+    explicit AhoCorasick(const std::vector<std::string>& patterns,
+                         const bool& case_insensitive = false);
+    AhoCorasick(const AhoCorasick&) = default;
+    AhoCorasick(AhoCorasick&&) noexcept = default;
+    AhoCorasick& operator=(const AhoCorasick&) = default;
+    AhoCorasick& operator=(AhoCorasick&&) noexcept = default;
+
+    virtual ~AhoCorasick() = default;
+
+    // amount of patterns
+    std::size_t size() const noexcept;
+
+    // the occurrence that ends first, nullopt if there is none
+    std::optional<Match> find(const std::string_view& text) const noexcept;
+    bool contains(const std::string_view& text) const noexcept;
+
+    // every occurrence, overlapping ones included, ordered by where they end
+    std::vector<Match> find_all(const std::string_view& text) const;
+
+    // call function(const Match&) for every occurrence, in find_all() order
+    template <typename Function>
+    void for_each(const std::string_view& text, Function function) const;
+
+protected:
+    using State = std::uint32_t;
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    // byte -> column in next_, 0 for bytes in no pattern
+    std::array<std::uint16_t, 256> class_of_ {};
+    std::size_t classes_ = 1;
+    // complete transition table, indexed by row + class where row is
+    // state * classes_. Transitions store the row of the target so a step is
+    // a single load, and states are numbered so those with an output (of
+    // their own or on their failure chain) come last: a step reaching row
+    // match_row_ or above has matched something. Root is state 0
+    std::vector<State> next_;
+    State match_row_ = 0;
+    // first pattern ending in a state, NONE if there is none
+    std::vector<std::uint32_t> output_;
+    // nearest state on the failure chain with an output, 0 if there is none
+    std::vector<State> output_link_;
+    // next pattern ending in the same state (duplicated patterns)
+    std::vector<std::uint32_t> same_output_;
+    std::vector<std::size_t> lengths_;
+
+    void build_(const std::vector<std::string_view>& patterns,
+                const bool& case_insensitive);
+
+    // row after reading `c` in `row`
+    State step_(const State& row, const char& c) const noexcept;
+};
+
+inline AhoCorasick::State AhoCorasick::step_(const State& row,
+                                             const char& c) const noexcept {
+    return next_[row + class_of_[static_cast<unsigned char>(c)]];
+}
+
+template <typename Function>
+void AhoCorasick::for_each(const std::string_view& text,
+                           Function function) const {
+    State row = 0;
+    for (std::size_t i = 0; i < text.length(); i++) {
+        row = step_(row, text[i]);
+        if (row < match_row_) {
+            continue;
+        }
+        State matched = row / static_cast<State>(classes_);
+        if (output_[matched] == NONE) {
+            matched = output_link_[matched];
+        }
+        while (matched != 0) {
+            for (std::uint32_t pattern = output_[matched]; pattern != NONE;
+                 pattern = same_output_[pattern]) {
+                function(Match {pattern, i + 1 - lengths_[pattern]});
+            }
+            matched = output_link_[matched];
+        }
+    }
+}
+
+} // namespace rayalto::utils::string
+
+#endif // RA_UTILS_RAUTILS_STRING_SEARCH_H_
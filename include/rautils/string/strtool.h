@@ -3,12 +3,17 @@
 
 #include <cstddef>
 #include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <map>
-#include <numeric>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
+#include "rautils/string/char_set.h"
+
 namespace rayalto::utils::string {
 
 // trim out space characters from string (from start)
@@ -80,48 +85,272 @@ std::pair<std::string, std::string> split_once(const std::string& str,
 std::pair<std::string, std::string> split_once(const std::string& str,
                                                const std::string& sep);
 
-// format a map to std::string like: "key1: value1, key2: value2"
+// the *_view versions below return views into `str`, which must outlive
+// them, and never allocate
+
+// trim out space characters from view (from start/end/both ends)
+std::string_view lstrip_view(std::string_view str);
+std::string_view rstrip_view(std::string_view str);
+std::string_view strip_view(std::string_view str);
+
+// trim out any of `chars` from view (from start/end/both ends)
+std::string_view lstrip_view(std::string_view str,
+                             const std::string_view& chars);
+std::string_view rstrip_view(std::string_view str,
+                             const std::string_view& chars);
+std::string_view strip_view(std::string_view str,
+                            const std::string_view& chars);
+
+// trim out characters in `chars` from view (from start/end/both ends), the
+// fastest way to strip: one table lookup per character
+std::string_view lstrip_view(std::string_view str, const CharSet& chars);
+std::string_view rstrip_view(std::string_view str, const CharSet& chars);
+std::string_view strip_view(std::string_view str, const CharSet& chars);
+
+// split view with specified char/string only once, second is empty if
+// `sep` is not found
+std::pair<std::string_view, std::string_view> split_once_view(
+    const std::string_view& str,
+    const char& sep);
+std::pair<std::string_view, std::string_view> split_once_view(
+    const std::string_view& str,
+    const std::string_view& sep);
+
+/**
+ * Lazy range of the tokens between separators, returned by split_view().
+ * Every token is yielded, empty ones included: "a,,b," gives "a", "", "b"
+ * and "". An empty separator yields `str` as the only token.
+ * Example:
+ *      for (std::string_view line : split_view(text, '\n')) { ... }
+ */
+template <typename Separator>
+class SplitView {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        Iterator() = default;
+        Iterator(const std::string_view& str, const Separator& separator) :
+            str_(str), separator_(separator), start_(0) {
+            find_end_();
+        }
+
+        reference operator*() const {
+            return token_;
+        }
+
+        pointer operator->() const {
+            return &token_;
+        }
+
+        Iterator& operator++() {
+            if (end_ == std::string_view::npos) {
+                start_ = std::string_view::npos;
+                return *this;
+            }
+            start_ = end_ + separator_length_();
+            find_end_();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return start_ == other.start_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return start_ != other.start_;
+        }
+
+    protected:
+        std::size_t separator_length_() const {
+            if constexpr (std::is_same_v<Separator, char>) {
+                return 1;
+            }
+            else {
+                return separator_.length();
+            }
+        }
+
+        void find_end_() {
+            end_ = separator_length_() == 0 ? std::string_view::npos
+                                            : str_.find(separator_, start_);
+            token_ = str_.substr(start_, end_ - start_);
+        }
+
+        std::string_view str_;
+        Separator separator_ {};
+        // start of the current token, npos once past the last one
+        std::size_t start_ = std::string_view::npos;
+        // separator after the current token, npos for the last one
+        std::size_t end_ = std::string_view::npos;
+        std::string_view token_;
+    };
+
+    SplitView(const std::string_view& str, const Separator& separator) :
+        str_(str), separator_(separator) {}
+
+    Iterator begin() const {
+        return Iterator(str_, separator_);
+    }
+
+    Iterator end() const {
+        return Iterator();
+    }
+
+protected:
+    std::string_view str_;
+    Separator separator_;
+};
+
+// split view with specified char/string lazily
+SplitView<char> split_view(const std::string_view& str, const char& sep);
+SplitView<std::string_view> split_view(const std::string_view& str,
+                                       const std::string_view& sep);
+
+// format a map to std::string like: "key1: value1, key2: value2", any map
+// of strings works (std::map, misc::FlatMap, ...). The output size is added
+// up first so it is allocated once, kv_format_to() appends to `out`
 // clang-format off
-std::string kv_format(
-    const std::map<std::string, std::string>& kvs,
+template <typename MapType>
+std::string& kv_format_to(
+    std::string& out,
+    const MapType& kvs,
     const char& kv_delimiter = ':',       // "key<?>value"
     const bool& kv_space = true,          // "key: value" or "key:value"
     const char& item_delimiter = ',',     // "k1:v1<?>k2:v2"
     const bool& item_sapce = true,        // "k1:v1, k2:v2" or "k1:v1,k2:v2"
     const bool& item_delimiter_end = true // "k1:v1,k2:v2," or "k1:v1,k2:v2"
-);
-// clang-format on
+) {
+    // clang-format on
+    const std::size_t kv_count = kvs.size();
+    if (kv_count == 0) {
+        return out;
+    }
+    std::size_t size = (kv_space ? 2 : 1) * kv_count
+                       + (item_sapce ? 2 : 1)
+                             * (item_delimiter_end ? kv_count : kv_count - 1);
+    for (const auto& kv : kvs) {
+        size += std::string_view(kv.first).length()
+                + std::string_view(kv.second).length();
+    }
+    out.reserve(out.length() + size);
+    std::size_t kv_index = 0;
+    for (const auto& kv : kvs) {
+        out.append(kv.first);
+        out.push_back(kv_delimiter);
+        if (kv_space) {
+            out.push_back(' ');
+        }
+        out.append(kv.second);
+        kv_index++;
+        if (item_delimiter_end || (kv_index != kv_count)) {
+            out.push_back(item_delimiter);
+            if (item_sapce) {
+                out.push_back(' ');
+            }
+        }
+    }
+    return out;
+}
 
-// case insensitive string compare
-bool compare_ic(const std::string& lv, const std::string& rv);
+// clang-format off
+template <typename MapType>
+std::string kv_format(
+    const MapType& kvs,
+    const char& kv_delimiter = ':',
+    const bool& kv_space = true,
+    const char& item_delimiter = ',',
+    const bool& item_sapce = true,
+    const bool& item_delimiter_end = true
+) {
+    // clang-format on
+    std::string result;
+    kv_format_to(result,
+                 kvs,
+                 kv_delimiter,
+                 kv_space,
+                 item_delimiter,
+                 item_sapce,
+                 item_delimiter_end);
+    return result;
+}
 
-// string join
-std::string join(const std::string& str,
-                 std::initializer_list<std::string> between);
+// case insensitive (ascii) string compare
+bool compare_ic(const std::string_view& lv, const std::string_view& rv);
 
+// string join: items separated by `separator`, items are anything
+// convertible to std::string_view (std::string, const char*, ...) in a
+// forward range. The output size is added up first so it is allocated once,
+// join_to() appends to `out`
 template <typename Iter>
-std::string join(std::string&& str, Iter begin, Iter end) {
-    return std::accumulate(std::next(begin),
-                           end,
-                           *begin,
-                           [&str](std::string l, std::string r) -> std::string {
-                               return std::move(l) + std::move(str)
-                                      + std::move(r);
-                           });
+std::string& join_to(std::string& out,
+                     const std::string_view& separator,
+                     Iter begin,
+                     Iter end) {
+    if (begin == end) {
+        return out;
+    }
+    std::size_t size = 0;
+    std::size_t item_count = 0;
+    for (Iter it = begin; it != end; ++it) {
+        size += std::string_view(*it).length();
+        item_count++;
+    }
+    out.reserve(out.length() + size + separator.length() * (item_count - 1));
+    out.append(std::string_view(*begin));
+    for (Iter it = std::next(begin); it != end; ++it) {
+        out.append(separator);
+        out.append(std::string_view(*it));
+    }
+    return out;
 }
 
-// count substring
-std::size_t count(const std::string& str, const std::string& substr);
+template <typename Range>
+std::string& join_to(std::string& out,
+                     const std::string_view& separator,
+                     const Range& items) {
+    return join_to(out, separator, std::begin(items), std::end(items));
+}
+
+template <typename Iter>
+std::string join(const std::string_view& separator, Iter begin, Iter end) {
+    std::string result;
+    join_to(result, separator, begin, end);
+    return result;
+}
+
+template <typename Range>
+std::string join(const std::string_view& separator, const Range& items) {
+    return join(separator, std::begin(items), std::end(items));
+}
+
+std::string join(const std::string_view& separator,
+                 std::initializer_list<std::string_view> items);
+
+// count non-overlapping occurrences of substring, see search.h for searching
+// the same substring many times or many substrings at once
+std::size_t count(const std::string_view& str, const std::string_view& substr);
 
 // if substring exists
-bool exists(const std::string& str, const std::string& substr);
+bool exists(const std::string_view& str, const std::string_view& substr);
 
-// random string
+// random string, see random_string.h for generating many of them
 std::string random_string(const std::size_t& len = 16);
 std::string random_string(const std::size_t& len,
                           const std::vector<char>& characters);
 
-// convert byte data to hex string
+// convert byte data to hex string, hex.h has versions writing into a buffer
 std::string hex_string(const std::vector<unsigned char>& data,
                        const bool& upper_case = false);
 std::string hex_string(const std::vector<unsigned char>& data,
@@ -0,0 +1,103 @@
+#include "rautils/misc/histogram.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace rayalto::utils::misc {
+
+void Histogram::record(const std::uint64_t& value) {
+    buckets_[bucket_index_(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t previous = min_.load(std::memory_order_relaxed);
+    while (value < previous
+           && !min_.compare_exchange_weak(
+               previous, value, std::memory_order_relaxed)) {}
+    previous = max_.load(std::memory_order_relaxed);
+    while (value > previous
+           && !max_.compare_exchange_weak(
+               previous, value, std::memory_order_relaxed)) {}
+}
+
+void Histogram::reset() {
+    for (std::atomic<std::uint64_t>& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::count() const {
+    return count_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::sum() const {
+    return sum_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::min() const {
+    return count() == 0 ? 0 : min_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::max() const {
+    return max_.load(std::memory_order_relaxed);
+}
+
+double Histogram::mean() const {
+    const std::uint64_t samples = count();
+    if (samples == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(sum()) / static_cast<double>(samples);
+}
+
+std::uint64_t Histogram::percentile(const double& percentile) const {
+    const std::uint64_t samples = count();
+    if (samples == 0) {
+        return 0;
+    }
+    std::uint64_t rank = static_cast<std::uint64_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(samples)));
+    if (rank == 0) {
+        rank = 1;
+    }
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            const std::uint64_t value = bucket_value_(i);
+            const std::uint64_t largest = max();
+            return value < largest ? value : largest;
+        }
+    }
+    return max();
+}
+
+std::size_t Histogram::bucket_index_(const std::uint64_t& value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<std::size_t>(value);
+    }
+    // value is in [16 << shift, 32 << shift)
+    const std::size_t shift =
+        63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    const std::size_t sub_bucket =
+        static_cast<std::size_t>(value >> shift) & (SUB_BUCKET_COUNT - 1);
+    return (shift + 1) * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+std::uint64_t Histogram::bucket_value_(const std::size_t& index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const std::size_t shift = index / SUB_BUCKET_COUNT - 1;
+    const std::uint64_t sub_bucket = index % SUB_BUCKET_COUNT;
+    const std::uint64_t lowest = (SUB_BUCKET_COUNT + sub_bucket) << shift;
+    return lowest + ((std::uint64_t {1} << shift) - 1);
+}
+
+} // namespace rayalto::utils::misc
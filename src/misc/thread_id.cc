@@ -1,30 +1,71 @@
 #include "rautils/misc/thread_id.h"
 
-#include <cstddef>
+#include <atomic>
+#include <functional>
 #include <mutex>
-#include <thread>
-#include <unordered_map>
+#include <queue>
+#include <vector>
 
 namespace rayalto::utils::misc {
 
-// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-static std::unordered_map<std::thread::id, unsigned int> thread_id_map;
-// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-static std::mutex thread_id_map_lock;
+namespace {
 
-unsigned int thread_id() {
-    std::thread::id thread = std::this_thread::get_id();
-    thread_id_map_lock.lock();
-    const std::unordered_map<std::thread::id, unsigned int>::const_iterator
-        found = thread_id_map.find(thread);
-    if (found == thread_id_map.end()) {
-        std::size_t id = thread_id_map.size() + 1;
-        thread_id_map.emplace(thread, id);
-        thread_id_map_lock.unlock();
-        return id;
+struct ThreadIdRegistry {
+    std::mutex lock;
+    // ids released by exited threads, smallest on top
+    std::priority_queue<unsigned int,
+                        std::vector<unsigned int>,
+                        std::greater<unsigned int>>
+        free_ids;
+    std::atomic<unsigned int> max_id = 0;
+};
+
+// never destroyed, detached threads may exit after static destruction
+ThreadIdRegistry& registry() {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    static ThreadIdRegistry* const registry = new ThreadIdRegistry;
+    return *registry;
+}
+
+// takes an id on the first thread_id() of a thread, gives it back on exit
+class ThreadIdHolder {
+public:
+    ThreadIdHolder() {
+        ThreadIdRegistry& ids = registry();
+        std::lock_guard<std::mutex> lock(ids.lock);
+        if (ids.free_ids.empty()) {
+            id = ids.max_id.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+        else {
+            id = ids.free_ids.top();
+            ids.free_ids.pop();
+        }
+    }
+
+    ThreadIdHolder(const ThreadIdHolder&) = delete;
+    ThreadIdHolder(ThreadIdHolder&&) noexcept = delete;
+    ThreadIdHolder& operator=(const ThreadIdHolder&) = delete;
+    ThreadIdHolder& operator=(ThreadIdHolder&&) noexcept = delete;
+
+    ~ThreadIdHolder() {
+        ThreadIdRegistry& ids = registry();
+        std::lock_guard<std::mutex> lock(ids.lock);
+        ids.free_ids.push(id);
     }
-    thread_id_map_lock.unlock();
-    return found->second;
+
+    unsigned int id = 0;
+};
+
+} // namespace
+
+unsigned int thread_id() {
+    // the registry is only locked once per thread
+    thread_local const ThreadIdHolder holder;
+    return holder.id;
+}
+
+unsigned int max_thread_id() {
+    return registry().max_id.load(std::memory_order_relaxed);
 }
 
 } // namespace rayalto::utils::misc
@@ -0,0 +1,293 @@
+#include "rautils/misc/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace rayalto::utils::misc {
+
+namespace {
+
+// the pool and worker index of the current thread, if it is a worker
+thread_local ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+// where the next steal attempt of this thread starts
+thread_local std::size_t steal_cursor = 0;
+
+} // namespace
+
+/**
+ * Chase-Lev deque ("Correct and Efficient Work-Stealing for Weak Memory
+ * Models", Le et al. 2013), the owner pushes and pops at the bottom, other
+ * threads steal from the top. Outgrown arrays are kept until destruction
+ * since a thief may still be reading them.
+ */
+class ThreadPool::WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(const std::int64_t& capacity);
+
+    WorkStealingDeque() = delete;
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&) noexcept = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) noexcept = delete;
+
+    virtual ~WorkStealingDeque() = default;
+
+    // owner only
+    void push(Task* task);
+    // owner only, nullptr if empty
+    Task* pop();
+    // any thread, nullptr if empty or lost a race
+    Task* steal();
+
+protected:
+    struct Array {
+        explicit Array(const std::int64_t& capacity) :
+            capacity(capacity),
+            cells(std::make_unique<std::atomic<Task*>[]>(
+                static_cast<std::size_t>(capacity))) {}
+
+        [[nodiscard]] Task* get(const std::int64_t& index) const {
+            return cells[static_cast<std::size_t>(index & (capacity - 1))].load(
+                std::memory_order_relaxed);
+        }
+
+        void put(const std::int64_t& index, Task* task) {
+            cells[static_cast<std::size_t>(index & (capacity - 1))].store(
+                task, std::memory_order_relaxed);
+        }
+
+        const std::int64_t capacity;
+        const std::unique_ptr<std::atomic<Task*>[]> cells;
+    };
+
+    alignas(64) std::atomic<std::int64_t> top_ = 0;
+    alignas(64) std::atomic<std::int64_t> bottom_ = 0;
+    std::atomic<Array*> array_ = nullptr;
+    // every array ever used, only touched by the owner
+    std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+ThreadPool::WorkStealingDeque::WorkStealingDeque(const std::int64_t& capacity) {
+    arrays_.emplace_back(std::make_unique<Array>(capacity));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+}
+
+void ThreadPool::WorkStealingDeque::push(Task* task) {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    Array* array = array_.load(std::memory_order_relaxed);
+    if (bottom - top > array->capacity - 1) {
+        // full, move to an array twice as large
+        arrays_.emplace_back(std::make_unique<Array>(array->capacity * 2));
+        Array* grown = arrays_.back().get();
+        for (std::int64_t i = top; i < bottom; i++) {
+            grown->put(i, array->get(i));
+        }
+        array_.store(grown, std::memory_order_release);
+        array = grown;
+    }
+    array->put(bottom, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+ThreadPool::Task* ThreadPool::WorkStealingDeque::pop() {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        // empty
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Task* task = array->get(bottom);
+    if (top == bottom) {
+        // the last one, race thieves for it
+        if (!top_.compare_exchange_strong(top,
+                                          top + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+ThreadPool::Task* ThreadPool::WorkStealingDeque::steal() {
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+    Array* array = array_.load(std::memory_order_acquire);
+    Task* task = array->get(top);
+    if (!top_.compare_exchange_strong(top,
+                                      top + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+struct ThreadPool::Worker {
+    WorkStealingDeque deque {256};
+    std::thread thread;
+};
+
+ThreadPool::ThreadPool(const std::size_t& threads, const bool& pin_threads) {
+    const std::size_t count = std::max<std::size_t>(threads, 1);
+    workers_.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        workers_.emplace_back(std::make_unique<Worker>());
+    }
+    // start only when every deque exists, workers steal from each other
+    const std::size_t cpus = default_threads();
+    for (std::size_t i = 0; i < count; i++) {
+        workers_[i]->thread = std::thread(&ThreadPool::worker_loop_, this, i);
+        if (pin_threads) {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(i % cpus, &cpu_set);
+            // best effort, e.g. a container may not allow it
+            pthread_setaffinity_np(workers_[i]->thread.native_handle(),
+                                   sizeof(cpu_set),
+                                   &cpu_set);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopped_ = true;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_all();
+    for (std::unique_ptr<Worker>& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+std::size_t ThreadPool::default_threads() {
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void ThreadPool::post(Task&& task) {
+    push_task_(new Task(std::move(task)));
+}
+
+std::size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+bool ThreadPool::run_pending_task() {
+    Task* task = take_task_(current_pool == this ? current_index : SIZE_MAX);
+    if (task == nullptr) {
+        return false;
+    }
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    std::unique_ptr<Task> owned(task);
+    (*owned)();
+    return true;
+}
+
+void ThreadPool::worker_loop_(const std::size_t& index) {
+    current_pool = this;
+    current_index = index;
+    steal_cursor = index + 1;
+    while (true) {
+        if (run_pending_task()) {
+            continue;
+        }
+        if (pending_.load() != 0) {
+            // a task is being pushed or a steal lost a race, try again
+            std::this_thread::yield();
+            continue;
+        }
+        if (stopped_) {
+            break;
+        }
+        sleepers_.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock,
+                       [this]() { return stopped_ || pending_.load() != 0; });
+        }
+        sleepers_.fetch_sub(1);
+    }
+    current_pool = nullptr;
+}
+
+ThreadPool::Task* ThreadPool::take_task_(const std::size_t& index) {
+    if (index < workers_.size()) {
+        Task* task = workers_[index]->deque.pop();
+        if (task != nullptr) {
+            return task;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        if (!shared_queue_.empty()) {
+            Task* task = shared_queue_.front();
+            shared_queue_.pop_front();
+            return task;
+        }
+    }
+    return steal_task_(index);
+}
+
+ThreadPool::Task* ThreadPool::steal_task_(const std::size_t& thief) {
+    const std::size_t count = workers_.size();
+    for (std::size_t i = 0; i < count; i++) {
+        const std::size_t victim = (steal_cursor + i) % count;
+        if (victim == thief) {
+            continue;
+        }
+        Task* task = workers_[victim]->deque.steal();
+        if (task != nullptr) {
+            // start at the same victim next time, it likely has more
+            steal_cursor = victim;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::push_task_(Task* task) {
+    if (current_pool == this) {
+        workers_[current_index]->deque.push(task);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        shared_queue_.push_back(task);
+    }
+    pending_.fetch_add(1);
+    if (sleepers_.load() != 0) {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        wake_.notify_one();
+    }
+}
+
+} // namespace rayalto::utils::misc
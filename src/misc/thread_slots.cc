@@ -0,0 +1,26 @@
+#include "rautils/misc/thread_slots.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace rayalto::utils::misc {
+
+void ShardedCounter::add(const std::int64_t& delta) {
+    shards_.local().fetch_add(delta, std::memory_order_relaxed);
+}
+
+std::int64_t ShardedCounter::value() const {
+    std::int64_t sum = 0;
+    shards_.for_each([&sum](const std::atomic<std::int64_t>& shard) -> void {
+        sum += shard.load(std::memory_order_relaxed);
+    });
+    return sum;
+}
+
+void ShardedCounter::reset() {
+    shards_.for_each([](std::atomic<std::int64_t>& shard) -> void {
+        shard.store(0, std::memory_order_relaxed);
+    });
+}
+
+} // namespace rayalto::utils::misc
@@ -6,6 +6,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -71,7 +73,7 @@ bool validate_uid_string(const std::string& uid) {
 }
 
 // NOLINTNEXTLINE(misc-no-recursion)
-std::uint16_t parse_hex_uint16(const std::string& hex_str) {
+std::uint16_t parse_hex_uint16(const std::string_view& hex_str) {
     const std::size_t hex_str_length = hex_str.length();
     switch (hex_str_length) {
     case 0: return 0; break;
@@ -113,14 +115,23 @@ Uid::Uid(const std::string& uid) {
         parts_.fill(0xffff);
         return;
     }
-    std::vector<std::string> parts_str = string::split(uid, ':');
+    // like std::getline, the trailing ':' of "ffff::" does not start
+    // another part
+    std::string_view parts_view(uid);
+    if (!parts_view.empty() && parts_view.back() == ':') {
+        parts_view.remove_suffix(1);
+    }
+    const string::SplitView<char> parts_str =
+        string::split_view(parts_view, ':');
+    const std::size_t parts_count = static_cast<std::size_t>(
+        std::distance(parts_str.begin(), parts_str.end()));
     std::size_t cursor = 0;
     bool zero_occurred = false; // in case of "::ffff" or "ffff::"
-    for (const std::string& part_str : parts_str) {
+    for (const std::string_view& part_str : parts_str) {
         if (part_str.empty() && !zero_occurred) {
             zero_occurred = true;
             // met "::", move cursor of parts to right side
-            cursor += 8 - parts_str.size();
+            cursor += 8 - parts_count;
         }
         parts_[cursor] = parse_hex_uint16(part_str);
         ++cursor;
@@ -1,5 +1,6 @@
 #include "rautils/network/general/cookie.h"
 
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
@@ -13,16 +14,24 @@ namespace rayalto::utils::network::general {
 
 Cookie::Cookie(
     std::initializer_list<std::pair<const std::string, std::string>> pairs) :
-    misc::DictHandler(pairs) {}
+    misc::FlatDictHandler(pairs) {}
 
-Cookie::Cookie(const misc::Dict& map) : misc::DictHandler(map) {}
+Cookie::Cookie(const misc::Dict& map) :
+    misc::FlatDictHandler(misc::FlatDict(map.begin(), map.end())) {}
 
-Cookie::Cookie(misc::Dict&& map) : misc::DictHandler(std::move(map)) {}
+Cookie::Cookie(misc::Dict&& map) :
+    misc::FlatDictHandler(misc::FlatDict(std::make_move_iterator(map.begin()),
+                                         std::make_move_iterator(map.end()))) {}
 
-Cookie::Cookie(const Cookie& cookie) : misc::DictHandler(cookie.map_) {}
+Cookie::Cookie(const misc::FlatDict& map) : misc::FlatDictHandler(map) {}
+
+Cookie::Cookie(misc::FlatDict&& map) :
+    misc::FlatDictHandler(std::move(map)) {}
+
+Cookie::Cookie(const Cookie& cookie) : misc::FlatDictHandler(cookie.map_) {}
 
 Cookie::Cookie(Cookie&& cookie) noexcept :
-    misc::DictHandler(std::move(cookie.map_)) {}
+    misc::FlatDictHandler(std::move(cookie.map_)) {}
 
 Cookie& Cookie::operator=(const Cookie& cookie) {
     if (this == &cookie) {
@@ -41,7 +50,9 @@ Cookie& Cookie::operator=(Cookie&& cookie) noexcept {
 }
 
 const char* Cookie::c_str() {
-    str_ = string::kv_format(map_, '=', false, ';');
+    // reuses the capacity of the last call
+    str_.clear();
+    string::kv_format_to(str_, map_, '=', false, ';');
     return str_.c_str();
 }
 
@@ -0,0 +1,314 @@
+#include "rautils/network/general/header.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rayalto::utils::network::general {
+
+Header::Header(const misc::DictIC& map) {
+    insert(map.begin(), map.end());
+}
+
+Header::Header(misc::DictIC&& map) {
+    for (auto& [name, value] : map) {
+        (*this)[name] = std::move(value);
+    }
+}
+
+Header::Header(const misc::FlatDictIC& map) {
+    insert(map.begin(), map.end());
+}
+
+Header::Header(misc::FlatDictIC&& map) {
+    for (auto& [name, value] : map) {
+        (*this)[name] = std::move(value);
+    }
+}
+
+Header::Header(
+    std::initializer_list<std::pair<const std::string, std::string>> pairs) {
+    for (const std::pair<const std::string, std::string>& pair : pairs) {
+        add({pair.first, pair.second});
+    }
+}
+
+std::string& Header::operator[](const std::string_view& name) {
+    const std::optional<HeaderId> id = header_id(name);
+    if (id.has_value()) {
+        return (*this)[*id];
+    }
+    misc::FlatDictIC::iterator found = others_.find(name);
+    if (found == others_.end()) {
+        found = others_.emplace(std::string(name), std::string()).first;
+    }
+    return found->second;
+}
+
+std::string& Header::operator[](const HeaderId& id) {
+    const std::size_t index = static_cast<std::size_t>(id);
+    if (!has_(index)) {
+        set_(index);
+    }
+    return known_[index];
+}
+
+Header::iterator Header::begin() {
+    return {this, next_known_(0)};
+}
+
+Header::const_iterator Header::begin() const {
+    return {this, next_known_(0)};
+}
+
+Header::const_iterator Header::cbegin() const {
+    return begin();
+}
+
+Header::iterator Header::end() {
+    return {this, KNOWN_COUNT + others_.size()};
+}
+
+Header::const_iterator Header::end() const {
+    return {this, KNOWN_COUNT + others_.size()};
+}
+
+Header::const_iterator Header::cend() const {
+    return end();
+}
+
+void Header::clear() {
+    for (std::size_t index = next_known_(0); index < KNOWN_COUNT;
+         index = next_known_(index + 1)) {
+        known_[index].clear();
+    }
+    present_.fill(0);
+    known_count_ = 0;
+    others_.clear();
+}
+
+bool Header::empty() const noexcept {
+    return known_count_ == 0 && others_.empty();
+}
+
+std::size_t Header::size() const noexcept {
+    return known_count_ + others_.size();
+}
+
+Header::iterator Header::find(const std::string_view& name) {
+    const std::optional<HeaderId> id = header_id(name);
+    if (id.has_value()) {
+        return find(*id);
+    }
+    misc::FlatDictIC::iterator found = others_.find(name);
+    if (found == others_.end()) {
+        return end();
+    }
+    return {this,
+            KNOWN_COUNT
+                + static_cast<std::size_t>(found - others_.begin())};
+}
+
+Header::const_iterator Header::find(const std::string_view& name) const {
+    return const_cast<Header*>(this)->find(name);
+}
+
+Header::iterator Header::find(const HeaderId& id) {
+    const std::size_t index = static_cast<std::size_t>(id);
+    return has_(index) ? iterator {this, index} : end();
+}
+
+Header::const_iterator Header::find(const HeaderId& id) const {
+    return const_cast<Header*>(this)->find(id);
+}
+
+Header::iterator Header::erase(const const_iterator& pos) {
+    if (pos.index_ < KNOWN_COUNT) {
+        unset_(pos.index_);
+        known_[pos.index_].clear();
+        return {this, next_known_(pos.index_ + 1)};
+    }
+    const std::size_t index = pos.index_ - KNOWN_COUNT;
+    others_.erase(others_.cbegin() + static_cast<std::ptrdiff_t>(index));
+    return {this, pos.index_};
+}
+
+Header::iterator Header::erase(const const_iterator& first,
+                               const const_iterator& last) {
+    // erasing shifts the later others_, count first
+    std::size_t count = 0;
+    for (const_iterator it = first; it != last; ++it) {
+        count += 1;
+    }
+    iterator pos {this, first.index_};
+    for (; count > 0; count--) {
+        pos = erase(pos);
+    }
+    return pos;
+}
+
+std::pair<Header::iterator, bool> Header::insert(
+    const std::pair<std::string, std::string>& item) {
+    iterator found = find(item.first);
+    if (found != end()) {
+        return {found, false};
+    }
+    (*this)[item.first] = item.second;
+    return {find(item.first), true};
+}
+
+std::pair<Header::iterator, bool> Header::insert(
+    std::pair<std::string, std::string>&& item) {
+    iterator found = find(item.first);
+    if (found != end()) {
+        return {found, false};
+    }
+    (*this)[item.first] = std::move(item.second);
+    return {find(item.first), true};
+}
+
+Header::iterator Header::insert(
+    const const_iterator& /* hint */,
+    const std::pair<std::string, std::string>& item) {
+    return insert(item).first;
+}
+
+Header::iterator Header::insert(const const_iterator& /* hint */,
+                                std::pair<std::string, std::string>&& item) {
+    return insert(std::move(item)).first;
+}
+
+void Header::insert(
+    std::initializer_list<std::pair<const std::string, std::string>> items) {
+    insert(items.begin(), items.end());
+}
+
+bool Header::exists(const std::string_view& name) const {
+    return find(name) != end();
+}
+
+bool Header::exists(const HeaderId& id) const {
+    return has_(static_cast<std::size_t>(id));
+}
+
+bool Header::remove(const std::string_view& name) {
+    const_iterator found = find(name);
+    if (found == end()) {
+        return false;
+    }
+    erase(found);
+    return true;
+}
+
+bool Header::remove(const HeaderId& id) {
+    const std::size_t index = static_cast<std::size_t>(id);
+    if (!has_(index)) {
+        return false;
+    }
+    unset_(index);
+    known_[index].clear();
+    return true;
+}
+
+std::size_t Header::remove(std::initializer_list<std::string_view> names) {
+    std::size_t count = 0;
+    for (const std::string_view& name : names) {
+        if (remove(name)) {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+bool Header::add(const std::pair<std::string, std::string>& item) {
+    return insert(item).second;
+}
+
+bool Header::add(std::pair<std::string, std::string>&& item) {
+    return insert(std::move(item)).second;
+}
+
+std::size_t Header::add(
+    std::initializer_list<std::pair<std::string, std::string>> items) {
+    std::size_t count = 0;
+    for (const std::pair<std::string, std::string>& item : items) {
+        if (add(item)) {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+bool Header::update(const std::pair<std::string, std::string>& item) {
+    std::string& previous_value = (*this)[item.first];
+    if (previous_value == item.second) {
+        return false;
+    }
+    previous_value = item.second;
+    return true;
+}
+
+bool Header::update(std::pair<std::string, std::string>&& item) {
+    std::string& previous_value = (*this)[item.first];
+    if (previous_value == item.second) {
+        return false;
+    }
+    previous_value = std::move(item.second);
+    return true;
+}
+
+std::size_t Header::update(
+    std::initializer_list<std::pair<std::string, std::string>> items) {
+    std::size_t count = 0;
+    for (const std::pair<std::string, std::string>& item : items) {
+        if (update(item)) {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+const misc::FlatDictIC Header::base_container() const {
+    misc::FlatDictIC map;
+    map.reserve(size());
+    for (const auto& [name, value] : *this) {
+        map.emplace(std::string(name), value);
+    }
+    return map;
+}
+
+bool Header::has_(const std::size_t& index) const {
+    return (present_[index / WORD_BITS] >> (index % WORD_BITS)) & 1U;
+}
+
+void Header::set_(const std::size_t& index) {
+    present_[index / WORD_BITS] |= std::uint64_t {1} << (index % WORD_BITS);
+    known_count_ += 1;
+}
+
+void Header::unset_(const std::size_t& index) {
+    present_[index / WORD_BITS] &= ~(std::uint64_t {1} << (index % WORD_BITS));
+    known_count_ -= 1;
+}
+
+std::size_t Header::next_known_(std::size_t index) const {
+    while (index < KNOWN_COUNT) {
+        std::uint64_t word = present_[index / WORD_BITS] >> (index % WORD_BITS);
+        if (word != 0) {
+            while ((word & 1U) == 0) {
+                word >>= 1;
+                index += 1;
+            }
+            return index;
+        }
+        // skip the rest of this word
+        index = (index / WORD_BITS + 1) * WORD_BITS;
+    }
+    return KNOWN_COUNT;
+}
+
+} // namespace rayalto::utils::network::general
@@ -7,6 +7,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 #include "rautils/network/general/authentication.h"
 #include "rautils/network/general/query.h"
@@ -14,6 +15,21 @@
 
 namespace rayalto::utils::network::general {
 
+namespace {
+
+// parse "k1=v1&k2=v2" into `query`, a repeated key keeps its last value
+void parse_query(const std::string_view& str, Query& query) {
+    for (const std::string_view& pair_str : string::split_view(str, '&')) {
+        if (pair_str.empty()) {
+            continue;
+        }
+        const auto [key, value] = string::split_once_view(pair_str, '=');
+        query[key] = value;
+    }
+}
+
+} // namespace
+
 Url::Url(const std::string& url) {
     from_string_(url);
 }
@@ -356,17 +372,13 @@ void Url::from_string_(const std::string& str) {
         if (query_end_pos == std::string::npos) {
             // remaining characters form the query component
             // and there are no other components
-            for (const std::string& pair_str :
-                 string::split(str.substr(query_start_pos), '&')) {
-                query_->update(string::split_once(pair_str, '='));
-            }
+            parse_query(std::string_view(str).substr(query_start_pos),
+                        *query_);
             return;
         }
-        for (const std::string& pair_str : string::split(
-                 str.substr(query_start_pos, query_end_pos - query_start_pos),
-                 '&')) {
-            query_->update(string::split_once(pair_str, '='));
-        }
+        parse_query(std::string_view(str).substr(
+                        query_start_pos, query_end_pos - query_start_pos),
+                    *query_);
     }
 
     std::size_t fragment_start_pos = str.find('#', query_end_pos);
@@ -410,8 +422,8 @@ void Url::form_string_() const {
     url_str += *path_;
     if (query_ != nullptr) {
         url_str += '?';
-        url_str += string::kv_format(
-            query_->base_container(), '=', false, '&', false, false);
+        string::kv_format_to(
+            url_str, query_->base_container(), '=', false, '&', false, false);
     }
     if (fragment_ != nullptr) {
         url_str += '#';
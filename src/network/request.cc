@@ -23,22 +23,23 @@ namespace {
 void parse_header(const char* data,
                   const std::size_t& size,
                   general::Header& result) {
-    for (std::string& header : string::split(std::string(data, size), '\n')) {
+    for (const std::string_view& header :
+         string::split_view(std::string_view(data, size), '\n')) {
         if (header.empty()) {
             // empty line
             continue;
         }
-        if (header.rfind("HTTP/", 0) == 0) {
+        if (header.substr(0, 5) == "HTTP/") {
             // something like 'HTTP/2 200'
             continue;
         }
         std::size_t colon = header.find(':');
-        if (colon == std::string::npos) {
+        if (colon == std::string_view::npos) {
             // failed to locate ':'
             continue;
         }
-        result[string::strip(header.substr(0, colon))] =
-            string::strip(header.substr(colon + 1));
+        result[string::strip_view(header.substr(0, colon))] =
+            string::strip_view(header.substr(colon + 1));
     }
 }
 
@@ -52,8 +53,8 @@ void init_curl_header(const std::unique_ptr<general::Header>& headers,
         return;
     }
     std::string header_line;
-    for (const std::pair<const std::string, std::string>& header : *headers) {
-        header_line = header.first + ": " + header.second;
+    for (const auto& header : *headers) {
+        header_line.assign(header.first).append(": ").append(header.second);
         *curl_header = curl_slist_append(*curl_header, header_line.c_str());
     }
 }
@@ -64,8 +65,20 @@ void parse_cookie_slist(curl_slist* curl_cookies, general::Cookie& cookie) {
     }
     for (curl_slist* curl_cookie = curl_cookies; curl_cookie != nullptr;
          curl_cookie = curl_cookie->next) {
-        std::vector<std::string> parts = string::split(curl_cookie->data, '\t');
-        cookie[parts[5]] = parts[6];
+        // netscape format, name and value are the 6th and 7th fields
+        std::size_t index = 0;
+        std::string_view name;
+        for (const std::string_view& part :
+             string::split_view(curl_cookie->data, '\t')) {
+            if (index == 5) {
+                name = part;
+            }
+            else if (index == 6) {
+                cookie[name] = part;
+                break;
+            }
+            index++;
+        }
     }
 }
 
@@ -388,7 +401,7 @@ Request::Impl& Request::Impl::body(const std::string& body,
     if (header_ == nullptr) {
         header_ = std::make_unique<general::Header>();
     }
-    (*header_)["content-type"] = mime_type;
+    (*header_)[general::HeaderId::CONTENT_TYPE] = mime_type;
     return *this;
 }
 
@@ -398,7 +411,7 @@ Request::Impl& Request::Impl::body(std::string&& body,
     if (header_ == nullptr) {
         header_ = std::make_unique<general::Header>();
     }
-    (*header_)["content-type"] = std::move(mime_type);
+    (*header_)[general::HeaderId::CONTENT_TYPE] = std::move(mime_type);
     return *this;
 }
 
@@ -1,12 +1,19 @@
 #include "rautils/network/websocket/client.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -14,6 +21,8 @@
 #include "libwebsockets.h"
 
 #include "rautils/misc/atomic_queue.h"
+#include "rautils/misc/histogram.h"
+#include "rautils/misc/thread_pool.h"
 #include "rautils/misc/thread_id.h"
 #include "rautils/network/general/cookie.h"
 #include "rautils/network/general/header.h"
@@ -24,6 +33,11 @@
 namespace rayalto::utils::network::websocket {
 
 constexpr const char* LWS_LOCAL_PROTOCOL_NAME = "ra-utils-websocket-client";
+constexpr const char* LWS_DEFLATE_EXTENSION_NAME = "permessage-deflate";
+// messages taken from the send queue at a time
+constexpr std::size_t SEND_BATCH_SIZE = 64;
+// a stream with no data yet is polled again after 1, 2, 4 ... ms, up to this
+constexpr std::uint32_t STREAM_RETRY_MAX_MS = 64;
 
 // only for custom header callback, function pointer is fucking disgusting
 struct LwsClientCustomHeaderContext {
@@ -32,19 +46,66 @@ struct LwsClientCustomHeaderContext {
     Client::ClientImpl& client_impl;
 };
 
+// lws_sul_schedule() only gives back the sul, so it has to be the first member
+struct LwsClientTimer {
+    lws_sorted_usec_list_t sul;
+    Client::ClientImpl* client_impl;
+};
+
+// an entry of the send queue
+struct OutgoingMessage {
+    // payload, or only the type if stream is set
+    Message message;
+    // pulls the payload chunk by chunk, see Client::send_stream()
+    Client::StreamCallback stream = nullptr;
+};
+
 int lws_client_callback(lws* wsi,
                         lws_callback_reasons reason,
                         void* user,
                         void* in,
                         std::size_t len);
 
-class Client::ClientImpl {
+void lws_client_reconnect(lws_sorted_usec_list_t* sul);
+
+void lws_client_keepalive(lws_sorted_usec_list_t* sul);
+
+void lws_client_stream_retry(lws_sorted_usec_list_t* sul);
+
+// nanoseconds since an arbitrary point, carried as ping payload
+std::int64_t steady_now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int lws_client_deflate_callback(lws_context* context,
+                                const lws_extension* ext,
+                                lws* wsi,
+                                lws_extension_callback_reasons reason,
+                                void* user,
+                                void* in,
+                                std::size_t len);
+
+class Client::ClientImpl
+    : public std::enable_shared_from_this<Client::ClientImpl> {
 public:
     friend int lws_client_callback(lws* wsi,
                                    lws_callback_reasons reason,
                                    void* user,
                                    void* in,
                                    std::size_t len);
+    friend int lws_client_deflate_callback(
+        lws_context* context,
+        const lws_extension* ext,
+        lws* wsi,
+        lws_extension_callback_reasons reason,
+        void* user,
+        void* in,
+        std::size_t len);
+    friend void lws_client_reconnect(lws_sorted_usec_list_t* sul);
+    friend void lws_client_keepalive(lws_sorted_usec_list_t* sul);
+    friend void lws_client_stream_retry(lws_sorted_usec_list_t* sul);
 
     explicit ClientImpl(Client& client);
     ClientImpl() = delete;
@@ -57,6 +118,11 @@ public:
 
     virtual ~ClientImpl();
 
+    // the Client is going away: disconnect, and never touch client_ or run a
+    // user callback again. When called from a callback, the service thread
+    // and the strand keep their references and the last one frees this
+    void release();
+
     void connect();
     void connect(const general::Url& url);
     void connect(general::Url&& url);
@@ -70,6 +136,16 @@ public:
     void disconnect(const std::string& message,
                     const std::uint16_t& close_status);
 
+    // ask the service thread to close the connection without waiting
+    void request_disconnect();
+    void request_disconnect(const std::string& message,
+                            const std::uint16_t& close_status);
+    // block until the service thread stopped serving the connection
+    void wait_stopped();
+    // wait_stopped(), then wait until on_close has run unless called from
+    // the service thread
+    void wait_disconnected();
+
     // if connection was established
     [[nodiscard]] bool connected() const;
 
@@ -103,6 +179,25 @@ public:
     void cookie(general::Cookie&& cookie);
     void cookie(std::nullptr_t);
 
+    // permessage-deflate extension
+    const std::unique_ptr<DeflateSetting>& deflate_setting();
+    void deflate_setting(const DeflateSetting& deflate_setting);
+    void deflate_setting(std::nullptr_t);
+
+    // max payload of a single frame
+    [[nodiscard]] const std::size_t& fragment_size() const;
+    void fragment_size(const std::size_t& fragment_size);
+
+    // ping/pong keepalive
+    const std::unique_ptr<KeepaliveSetting>& keepalive_setting();
+    void keepalive_setting(const KeepaliveSetting& keepalive_setting);
+    void keepalive_setting(std::nullptr_t);
+
+    // automatic reconnect
+    const std::unique_ptr<ReconnectSetting>& reconnect_setting();
+    void reconnect_setting(const ReconnectSetting& reconnect_setting);
+    void reconnect_setting(std::nullptr_t);
+
     // callback on connection error
     const std::unique_ptr<ErrorCallback>& on_error();
     void on_error(const ErrorCallback& callback);
@@ -121,15 +216,39 @@ public:
     void on_receive(ReceiveCallback&& callback);
     void on_receive(std::nullptr_t);
 
+    // callback on every piece of a message
+    const std::unique_ptr<FragmentCallback>& on_fragment();
+    void on_fragment(const FragmentCallback& callback);
+    void on_fragment(FragmentCallback&& callback);
+    void on_fragment(std::nullptr_t);
+
     // callback on connection closure
     const std::unique_ptr<CloseCallback>& on_close();
     void on_close(const CloseCallback& callback);
     void on_close(CloseCallback&& callback);
     void on_close(std::nullptr_t);
 
+    // callback on re-establishment after an automatic reconnect
+    const std::unique_ptr<ReconnectCallback>& on_reconnect();
+    void on_reconnect(const ReconnectCallback& callback);
+    void on_reconnect(ReconnectCallback&& callback);
+    void on_reconnect(std::nullptr_t);
+
+    // where callbacks run
+    const std::unique_ptr<Executor>& executor();
+    void executor(const Executor& executor);
+    void executor(Executor&& executor);
+    void executor(std::nullptr_t);
+
     // send message to server
     void send(const Message& message);
     void send(Message&& message);
+    void send_stream(const Message::Type& type, StreamCallback&& callback);
+
+    [[nodiscard]] Stats stats() const;
+
+    [[nodiscard]] const misc::Histogram& rtt() const;
+    [[nodiscard]] const misc::Histogram& delivery_latency() const;
 
 protected:
     /* libwebsockets stuff */
@@ -139,15 +258,24 @@ protected:
     lws_protocols ws_protocols_[2] {
         {LWS_LOCAL_PROTOCOL_NAME, lws_client_callback, 0, 0, 0, nullptr, 0},
         LWS_PROTOCOL_LIST_TERM};
+    lws_extension ws_extensions_[2] {
+        {LWS_DEFLATE_EXTENSION_NAME, lws_client_deflate_callback, nullptr},
+        {nullptr, nullptr, nullptr}};
     lws_client_connect_info ws_connection_info_ {};
+    // lws pings idle connections and hangs up half-open ones by this policy
+    lws_retry_bo_t ws_keepalive_policy_ {};
 
     /* core */
+    // guards ws_context_ against being destroyed while waking lws up
     std::mutex wake_lws_;
-    std::atomic<bool> new_message_ = false;
     std::atomic<bool> interrupted_ = false;
     std::atomic<bool> stopped_ = true;
+    // set by release(), client_ may be dangling
+    std::atomic<bool> released_ = false;
+    std::mutex stopped_mutex_;
+    std::condition_variable stopped_cv_;
     std::unique_ptr<std::thread> work_thread_ = nullptr;
-    misc::AtomicQueue<Message> message_queue_;
+    misc::AtomicQueue<OutgoingMessage> message_queue_;
 
     /* configuration */
     std::unique_ptr<general::Url> url_ = nullptr;
@@ -157,21 +285,150 @@ protected:
     std::unique_ptr<general::Cookie> cookie_ = nullptr;
     std::unique_ptr<std::uint16_t> local_close_status_ = nullptr;
     std::unique_ptr<std::string> local_close_message_ = nullptr;
+    std::unique_ptr<DeflateSetting> deflate_setting_ = nullptr;
+    std::size_t fragment_size_ = DEFAULT_FRAGMENT_SIZE;
+    // "permessage-deflate; ..." offered in the handshake
+    std::string deflate_offer_;
+    std::unique_ptr<KeepaliveSetting> keepalive_setting_ = nullptr;
+    std::unique_ptr<ReconnectSetting> reconnect_setting_ = nullptr;
 
     /* callback */
     Client& client_;
     std::unique_ptr<ErrorCallback> on_error_ = nullptr;
     std::unique_ptr<EstablishCallback> on_establish_ = nullptr;
     std::unique_ptr<ReceiveCallback> on_receive_ = nullptr;
+    std::unique_ptr<FragmentCallback> on_fragment_ = nullptr;
     std::unique_ptr<CloseCallback> on_close_ = nullptr;
+    std::unique_ptr<ReconnectCallback> on_reconnect_ = nullptr;
+    std::unique_ptr<Executor> executor_ = nullptr;
+
+    /* strand serializing callbacks on executor_ */
+    std::mutex strand_mutex_;
+    std::condition_variable strand_cv_;
+    std::deque<std::function<void()>> strand_queue_;
+    // whether a run_strand_() is submitted or running
+    bool strand_running_ = false;
+    // thread inside run_strand_(), to not wait for ourselves
+    std::thread::id strand_thread_;
+    misc::Histogram delivery_latency_;
 
     /* response from server */
     std::unique_ptr<general::Header> server_header_ = nullptr;
     std::unique_ptr<Message> receive_message_ = nullptr;
+    // type of the message being received
+    Message::Type receive_type_ = Message::Type::TEXT;
     std::unique_ptr<std::uint16_t> close_status_ = nullptr;
     std::unique_ptr<std::string> close_message_ = nullptr;
 
+    /* automatic reconnect, only touched by the service thread */
+    LwsClientTimer reconnect_timer_ {{}, this};
+    // a reconnect attempt is scheduled but not started yet
+    bool reconnect_pending_ = false;
+    // consecutive failed attempts since the last establishment
+    std::uint32_t reconnect_failures_ = 0;
+    // whether the connection in progress was started by lws_client_reconnect
+    bool reconnecting_ = false;
+    std::mt19937 reconnect_random_ {std::random_device {}()};
+    // messages returned by on_reconnect, sent before message_queue_
+    std::deque<OutgoingMessage> replay_queue_;
+    // taken from message_queue_ with one lock, sent from batch_next_ on
+    std::vector<OutgoingMessage> batch_;
+    std::size_t batch_next_ = 0;
+    // message interrupted by the closure, sent again after replay_queue_
+    std::unique_ptr<OutgoingMessage> resend_ = nullptr;
+
+    /* sending, only touched by the service thread */
+    // message being sent, nullptr if none
+    std::unique_ptr<OutgoingMessage> sending_ = nullptr;
+    // payload bytes of sending_ already written
+    std::size_t sending_offset_ = 0;
+    // whether no frame of sending_ has been written yet
+    bool sending_first_ = true;
+    // LWS_PRE bytes of header room followed by the payload of a frame
+    std::vector<unsigned char> send_buffer_;
+    // wakes the service thread up when a stream had no data yet
+    LwsClientTimer stream_timer_ {{}, this};
+    // current stream retry delay in ms, 0 if the last chunk had data
+    std::uint32_t stream_backoff_ = 0;
+
+    /* keepalive, only touched by the service thread */
+    LwsClientTimer keepalive_timer_ {{}, this};
+    // a ping should be sent in the next LWS_CALLBACK_CLIENT_WRITEABLE
+    bool ping_due_ = false;
+    // a ping was sent and its pong has not arrived yet
+    bool ping_outstanding_ = false;
+    // payload of the last ping, see steady_now()
+    std::int64_t ping_sent_at_ = 0;
+    misc::Histogram rtt_;
+
+    /* permessage-deflate */
+    // whether the message being sent goes through the deflate extension
+    bool deflate_message_ = false;
+    // whether the message being received came through the deflate extension
+    bool inflate_message_ = false;
+
+    /* statistics */
+    std::atomic<std::uint64_t> compressed_bytes_in_ = 0;
+    std::atomic<std::uint64_t> compressed_bytes_out_ = 0;
+    std::atomic<std::uint64_t> original_bytes_in_ = 0;
+    std::atomic<std::uint64_t> original_bytes_out_ = 0;
+    std::atomic<std::uint64_t> unexpected_closes_ = 0;
+    std::atomic<std::uint64_t> reconnect_attempts_ = 0;
+    std::atomic<std::uint64_t> reconnects_ = 0;
+    std::atomic<std::uint64_t> pong_timeouts_ = 0;
+    std::atomic<std::uint64_t> frames_in_ = 0;
+    std::atomic<std::uint64_t> frames_out_ = 0;
+    std::atomic<std::uint64_t> bytes_in_ = 0;
+    std::atomic<std::uint64_t> bytes_out_ = 0;
+    std::atomic<std::uint64_t> messages_in_ = 0;
+    std::atomic<std::uint64_t> messages_out_ = 0;
+    std::atomic<std::uint64_t> queued_messages_ = 0;
+    std::atomic<std::uint64_t> queued_bytes_ = 0;
+    std::atomic<std::uint64_t> peak_queued_bytes_ = 0;
+    std::atomic<std::uint64_t> writable_callbacks_ = 0;
+    std::atomic<std::uint64_t> partial_writes_ = 0;
+    std::atomic<std::uint64_t> callbacks_ = 0;
+    std::atomic<std::uint64_t> callback_nanoseconds_ = 0;
+
+    // accounts the time until it goes out of scope to user callbacks
+    struct CallbackTimer {
+        explicit CallbackTimer(ClientImpl& client_impl);
+        ~CallbackTimer();
+
+        ClientImpl& client_impl;
+        const std::chrono::steady_clock::time_point start;
+    };
+
     void wake_lws_up_();
+    void mark_stopped_();
+    [[nodiscard]] bool in_work_thread_() const;
+    void join_work_thread_();
+    // take ws_context_ under wake_lws_ and destroy it outside, as callbacks
+    // fired by lws_context_destroy() may wake lws up
+    void destroy_context_();
+    // schedule lws_client_reconnect, return false if it should not reconnect
+    bool schedule_reconnect_();
+    // (re)arm lws_client_keepalive after `delay` milliseconds
+    void schedule_keepalive_(const std::uint32_t& delay);
+    void stop_keepalive_();
+    // run a user callback on executor_, or inline if there is none
+    void dispatch_(std::function<void()>&& callback);
+    // run the callbacks queued so far, resubmit itself if more arrived
+    void run_strand_();
+    // wait until all dispatched callbacks ran
+    void wait_strand_();
+    // keep queued_messages_/queued_bytes_ in step with message_queue_
+    void enqueued_(const OutgoingMessage& message);
+    void dequeued_(const OutgoingMessage& message);
+    // whether anything is left to send, only for the service thread
+    [[nodiscard]] bool has_outgoing_();
+    // take the next message to send into sending_, return false if none
+    bool next_message_();
+    // write the next frame of sending_, return -1 on failure, 1 if a stream
+    // had no data yet and stream_timer_ will ask for writable again
+    int write_fragment_(lws* wsi);
+    void stop_stream_retry_();
+    void form_deflate_offer_();
     void reset_config_();
 };
 
@@ -188,18 +445,32 @@ Client::ClientImpl::ClientImpl(Client& client) : client_(client) {
 }
 
 Client::ClientImpl::~ClientImpl() {
+    if (in_work_thread_()) {
+        // the service thread dropped the last reference, it touches nothing
+        // of this afterwards and cannot join itself
+        work_thread_->detach();
+    }
+    join_work_thread_();
+    destroy_context_();
+}
+
+void Client::ClientImpl::release() {
+    released_ = true;
     if (!stopped_) {
         disconnect();
     }
-    if (work_thread_ != nullptr && work_thread_->joinable()) {
-        work_thread_->detach();
-    }
-    if (ws_context_ != nullptr) {
-        lws_context_destroy(ws_context_);
+    if (in_work_thread_()) {
+        // the service thread and the strand hold their own references
+        return;
     }
+    wait_strand_();
+    join_work_thread_();
 }
 
 void Client::ClientImpl::connect() {
+    // the previous service thread may still be destroying its context
+    join_work_thread_();
+
     if (url_ != nullptr) {
         if (url_->host() != nullptr) {
             ws_connection_info_.address = url_->host()->c_str();
@@ -230,6 +501,35 @@ void Client::ClientImpl::connect() {
         ws_connection_info_.protocol = protocol_->c_str();
     }
 
+    if (keepalive_setting_ != nullptr) {
+        const std::uint32_t ping_seconds =
+            std::max<std::uint32_t>(keepalive_setting_->ping_interval / 1000, 1);
+        const std::uint32_t hangup_seconds = std::max<std::uint32_t>(
+            (keepalive_setting_->ping_interval
+             + keepalive_setting_->pong_timeout)
+                / 1000,
+            ping_seconds + 1);
+        ws_keepalive_policy_.secs_since_valid_ping =
+            static_cast<std::uint16_t>(std::min<std::uint32_t>(ping_seconds,
+                                                               UINT16_MAX));
+        ws_keepalive_policy_.secs_since_valid_hangup =
+            static_cast<std::uint16_t>(std::min<std::uint32_t>(hangup_seconds,
+                                                               UINT16_MAX));
+        ws_connection_info_.retry_and_idle_policy = &ws_keepalive_policy_;
+    }
+    else {
+        ws_connection_info_.retry_and_idle_policy = nullptr;
+    }
+
+    if (deflate_setting_ != nullptr) {
+        form_deflate_offer_();
+        ws_extensions_[0].client_offer = deflate_offer_.c_str();
+        ws_context_info_.extensions = ws_extensions_;
+    }
+    else {
+        ws_context_info_.extensions = nullptr;
+    }
+
     ws_context_ = lws_create_context(&ws_context_info_);
     if (ws_context_ == nullptr) {
         if (on_error_ != nullptr) {
@@ -240,26 +540,42 @@ void Client::ClientImpl::connect() {
 
     ws_connection_info_.context = ws_context_;
 
-    if (lws_client_connect_via_info(&ws_connection_info_) == nullptr) {
-        if (on_error_ != nullptr) {
-            (*on_error_)(client_, "libwebsockets: Failed to connect");
-        }
-        return;
-    }
-
-    new_message_ = !message_queue_.empty();
+    sending_ = nullptr;
+    resend_ = nullptr;
+    replay_queue_.clear();
     interrupted_ = false;
     stopped_ = false;
 
-    work_thread_ = std::make_unique<std::thread>([&]() -> void {
-        int status = 0;
-        while (status >= 0 && !stopped_) {
-            status = lws_service(ws_context_, 0);
+    if (lws_client_connect_via_info(&ws_connection_info_) == nullptr
+        && !reconnect_pending_) {
+        if (!stopped_) {
+            // failed before lws could report
+            // LWS_CALLBACK_CLIENT_CONNECTION_ERROR
+            if (on_error_ != nullptr) {
+                (*on_error_)(client_, "libwebsockets: Failed to connect");
+            }
+            mark_stopped_();
         }
-        lws_context_destroy(ws_context_);
-        ws_context_ = nullptr;
-    });
-    work_thread_->detach();
+        destroy_context_();
+        return;
+    }
+    // a reconnect scheduled by a failed attempt runs on the service thread
+
+    // the thread holds a reference, the Client may be destroyed by one of the
+    // callbacks it runs
+    work_thread_ = std::make_unique<std::thread>(
+        [this, self = shared_from_this()]() mutable -> void {
+            int status = 0;
+            while (status >= 0 && !stopped_) {
+                status = lws_service(ws_context_, 0);
+            }
+            // an open connection gets LWS_CALLBACK_CLIENT_CLOSED in here,
+            // whose on_close may call send() or disconnect()
+            destroy_context_();
+            // lws_service() may fail without closing the connection
+            mark_stopped_();
+            self = nullptr;
+        });
 }
 
 void Client::ClientImpl::connect(const general::Url& url) {
@@ -273,12 +589,8 @@ void Client::ClientImpl::connect(general::Url&& url) {
 }
 
 void Client::ClientImpl::disconnect() {
-    interrupted_ = true;
-    wake_lws_up_();
-    while (!stopped_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(15));
-    }
-    interrupted_ = false;
+    request_disconnect();
+    wait_disconnected();
 }
 
 void Client::ClientImpl::disconnect(const CloseStatus& close_status) {
@@ -305,6 +617,36 @@ void Client::ClientImpl::disconnect(const std::string& message,
     disconnect();
 }
 
+void Client::ClientImpl::request_disconnect() {
+    interrupted_ = true;
+    wake_lws_up_();
+}
+
+void Client::ClientImpl::request_disconnect(const std::string& message,
+                                            const std::uint16_t& close_status) {
+    local_close_message_ = std::make_unique<std::string>(message);
+    local_close_status_ = std::make_unique<std::uint16_t>(close_status);
+    request_disconnect();
+}
+
+void Client::ClientImpl::wait_stopped() {
+    if (in_work_thread_()) {
+        // called from a callback, the connection closes after it returns
+        return;
+    }
+    std::unique_lock<std::mutex> lock(stopped_mutex_);
+    stopped_cv_.wait(lock, [this]() -> bool { return stopped_; });
+    interrupted_ = false;
+}
+
+void Client::ClientImpl::wait_disconnected() {
+    wait_stopped();
+    if (!in_work_thread_()) {
+        // so on_close has run when disconnect() returns
+        wait_strand_();
+    }
+}
+
 bool Client::ClientImpl::connected() const {
     return !stopped_;
 }
@@ -389,6 +731,55 @@ void Client::ClientImpl::cookie(std::nullptr_t) {
     cookie_ = nullptr;
 }
 
+const std::unique_ptr<Client::DeflateSetting>&
+Client::ClientImpl::deflate_setting() {
+    return deflate_setting_;
+}
+
+void Client::ClientImpl::deflate_setting(const DeflateSetting& deflate_setting) {
+    deflate_setting_ = std::make_unique<DeflateSetting>(deflate_setting);
+}
+
+void Client::ClientImpl::deflate_setting(std::nullptr_t) {
+    deflate_setting_ = nullptr;
+}
+
+const std::size_t& Client::ClientImpl::fragment_size() const {
+    return fragment_size_;
+}
+
+void Client::ClientImpl::fragment_size(const std::size_t& fragment_size) {
+    fragment_size_ = fragment_size;
+}
+
+const std::unique_ptr<Client::KeepaliveSetting>&
+Client::ClientImpl::keepalive_setting() {
+    return keepalive_setting_;
+}
+
+void Client::ClientImpl::keepalive_setting(
+    const KeepaliveSetting& keepalive_setting) {
+    keepalive_setting_ = std::make_unique<KeepaliveSetting>(keepalive_setting);
+}
+
+void Client::ClientImpl::keepalive_setting(std::nullptr_t) {
+    keepalive_setting_ = nullptr;
+}
+
+const std::unique_ptr<Client::ReconnectSetting>&
+Client::ClientImpl::reconnect_setting() {
+    return reconnect_setting_;
+}
+
+void Client::ClientImpl::reconnect_setting(
+    const ReconnectSetting& reconnect_setting) {
+    reconnect_setting_ = std::make_unique<ReconnectSetting>(reconnect_setting);
+}
+
+void Client::ClientImpl::reconnect_setting(std::nullptr_t) {
+    reconnect_setting_ = nullptr;
+}
+
 const std::unique_ptr<Client::ErrorCallback>& Client::ClientImpl::on_error() {
     return on_error_;
 }
@@ -439,6 +830,23 @@ void Client::ClientImpl::on_receive(std::nullptr_t) {
     on_receive_ = nullptr;
 }
 
+const std::unique_ptr<Client::FragmentCallback>&
+Client::ClientImpl::on_fragment() {
+    return on_fragment_;
+}
+
+void Client::ClientImpl::on_fragment(const FragmentCallback& callback) {
+    on_fragment_ = std::make_unique<FragmentCallback>(callback);
+}
+
+void Client::ClientImpl::on_fragment(FragmentCallback&& callback) {
+    on_fragment_ = std::make_unique<FragmentCallback>(std::move(callback));
+}
+
+void Client::ClientImpl::on_fragment(std::nullptr_t) {
+    on_fragment_ = nullptr;
+}
+
 const std::unique_ptr<Client::CloseCallback>& Client::ClientImpl::on_close() {
     return on_close_;
 }
@@ -455,24 +863,455 @@ void Client::ClientImpl::on_close(std::nullptr_t) {
     on_close_ = nullptr;
 }
 
+const std::unique_ptr<Client::ReconnectCallback>&
+Client::ClientImpl::on_reconnect() {
+    return on_reconnect_;
+}
+
+void Client::ClientImpl::on_reconnect(const ReconnectCallback& callback) {
+    on_reconnect_ = std::make_unique<ReconnectCallback>(callback);
+}
+
+void Client::ClientImpl::on_reconnect(ReconnectCallback&& callback) {
+    on_reconnect_ = std::make_unique<ReconnectCallback>(std::move(callback));
+}
+
+void Client::ClientImpl::on_reconnect(std::nullptr_t) {
+    on_reconnect_ = nullptr;
+}
+
 void Client::ClientImpl::send(const Message& message) {
-    message_queue_.push(message);
-    new_message_ = !message_queue_.empty();
+    OutgoingMessage outgoing {message};
+    enqueued_(outgoing);
+    message_queue_.push(std::move(outgoing));
     wake_lws_up_();
 }
 
 void Client::ClientImpl::send(Message&& message) {
-    message_queue_.push(std::move(message));
-    new_message_ = !message_queue_.empty();
+    OutgoingMessage outgoing {std::move(message)};
+    enqueued_(outgoing);
+    message_queue_.push(std::move(outgoing));
+    wake_lws_up_();
+}
+
+void Client::ClientImpl::send_stream(const Message::Type& type,
+                                     StreamCallback&& callback) {
+    OutgoingMessage outgoing {Message {}, std::move(callback)};
+    outgoing.message.type(type);
+    enqueued_(outgoing);
+    message_queue_.push(std::move(outgoing));
     wake_lws_up_();
 }
 
+Client::Stats Client::ClientImpl::stats() const {
+    Stats stats;
+    stats.compressed_bytes_in =
+        compressed_bytes_in_.load(std::memory_order_relaxed);
+    stats.compressed_bytes_out =
+        compressed_bytes_out_.load(std::memory_order_relaxed);
+    stats.original_bytes_in =
+        original_bytes_in_.load(std::memory_order_relaxed);
+    stats.original_bytes_out =
+        original_bytes_out_.load(std::memory_order_relaxed);
+    stats.unexpected_closes =
+        unexpected_closes_.load(std::memory_order_relaxed);
+    stats.reconnect_attempts =
+        reconnect_attempts_.load(std::memory_order_relaxed);
+    stats.reconnects = reconnects_.load(std::memory_order_relaxed);
+    stats.pong_timeouts = pong_timeouts_.load(std::memory_order_relaxed);
+    stats.frames_in = frames_in_.load(std::memory_order_relaxed);
+    stats.frames_out = frames_out_.load(std::memory_order_relaxed);
+    stats.bytes_in = bytes_in_.load(std::memory_order_relaxed);
+    stats.bytes_out = bytes_out_.load(std::memory_order_relaxed);
+    stats.messages_in = messages_in_.load(std::memory_order_relaxed);
+    stats.messages_out = messages_out_.load(std::memory_order_relaxed);
+    stats.queued_messages = queued_messages_.load(std::memory_order_relaxed);
+    stats.queued_bytes = queued_bytes_.load(std::memory_order_relaxed);
+    stats.peak_queued_bytes =
+        peak_queued_bytes_.load(std::memory_order_relaxed);
+    stats.writable_callbacks =
+        writable_callbacks_.load(std::memory_order_relaxed);
+    stats.partial_writes = partial_writes_.load(std::memory_order_relaxed);
+    stats.callbacks = callbacks_.load(std::memory_order_relaxed);
+    stats.callback_nanoseconds =
+        callback_nanoseconds_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const misc::Histogram& Client::ClientImpl::rtt() const {
+    return rtt_;
+}
+
+const misc::Histogram& Client::ClientImpl::delivery_latency() const {
+    return delivery_latency_;
+}
+
+const std::unique_ptr<Client::Executor>& Client::ClientImpl::executor() {
+    return executor_;
+}
+
+void Client::ClientImpl::executor(const Executor& executor) {
+    executor_ = std::make_unique<Executor>(executor);
+}
+
+void Client::ClientImpl::executor(Executor&& executor) {
+    executor_ = std::make_unique<Executor>(std::move(executor));
+}
+
+void Client::ClientImpl::executor(std::nullptr_t) {
+    executor_ = nullptr;
+}
+
+void Client::ClientImpl::dispatch_(std::function<void()>&& callback) {
+    const auto queued_at = std::chrono::steady_clock::now();
+    if (released_) {
+        return;
+    }
+    if (executor_ == nullptr) {
+        delivery_latency_.record(0);
+        CallbackTimer timer(*this);
+        callback();
+        return;
+    }
+    bool submit = false;
+    {
+        std::lock_guard<std::mutex> lock(strand_mutex_);
+        strand_queue_.emplace_back(
+            [this, callback = std::move(callback), queued_at]() -> void {
+                delivery_latency_.record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - queued_at)
+                        .count()));
+                if (released_) {
+                    // queued before the Client was destroyed
+                    return;
+                }
+                CallbackTimer timer(*this);
+                callback();
+            });
+        submit = !strand_running_;
+        strand_running_ = true;
+    }
+    if (submit) {
+        // outside the lock in case the executor runs tasks inline
+        (*executor_)([self = shared_from_this()]() -> void {
+            self->run_strand_();
+        });
+    }
+}
+
+void Client::ClientImpl::run_strand_() {
+    std::deque<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(strand_mutex_);
+        tasks.swap(strand_queue_);
+        strand_thread_ = std::this_thread::get_id();
+    }
+    // a batch at a time so clients sharing an executor take turns
+    for (std::function<void()>& task : tasks) {
+        task();
+    }
+    bool more = false;
+    {
+        std::lock_guard<std::mutex> lock(strand_mutex_);
+        strand_thread_ = std::thread::id {};
+        more = !strand_queue_.empty();
+        strand_running_ = more;
+    }
+    if (more) {
+        (*executor_)([self = shared_from_this()]() -> void {
+            self->run_strand_();
+        });
+    }
+    else {
+        strand_cv_.notify_all();
+    }
+}
+
+void Client::ClientImpl::wait_strand_() {
+    std::unique_lock<std::mutex> lock(strand_mutex_);
+    if (strand_thread_ == std::this_thread::get_id()) {
+        return;
+    }
+    strand_cv_.wait(lock, [this]() { return !strand_running_; });
+}
+
 void Client::ClientImpl::wake_lws_up_() {
     wake_lws_.lock();
-    lws_callback_on_writable(ws_instance_);
+    if (ws_context_ != nullptr && !stopped_) {
+        // the only thread-safe lws api, LWS_CALLBACK_EVENT_WAIT_CANCELLED
+        // then asks for LWS_CALLBACK_CLIENT_WRITEABLE in the service thread
+        lws_cancel_service(ws_context_);
+    }
     wake_lws_.unlock();
 }
 
+void Client::ClientImpl::mark_stopped_() {
+    {
+        std::lock_guard<std::mutex> lock(stopped_mutex_);
+        stopped_ = true;
+    }
+    stopped_cv_.notify_all();
+}
+
+bool Client::ClientImpl::in_work_thread_() const {
+    return work_thread_ != nullptr
+           && work_thread_->get_id() == std::this_thread::get_id();
+}
+
+void Client::ClientImpl::join_work_thread_() {
+    if (work_thread_ != nullptr && work_thread_->joinable()) {
+        work_thread_->join();
+    }
+    work_thread_ = nullptr;
+}
+
+void Client::ClientImpl::destroy_context_() {
+    lws_context* context = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(wake_lws_);
+        std::swap(context, ws_context_);
+    }
+    if (context != nullptr) {
+        lws_context_destroy(context);
+    }
+}
+
+bool Client::ClientImpl::schedule_reconnect_() {
+    // nullptr while the context is being destroyed
+    if (reconnect_setting_ == nullptr || interrupted_
+        || ws_context_ == nullptr) {
+        return false;
+    }
+    const ReconnectSetting& setting = *reconnect_setting_;
+    if (setting.max_attempts != 0
+        && reconnect_failures_ >= setting.max_attempts) {
+        return false;
+    }
+
+    // exponential backoff, randomly shortened by up to `jitter`
+    double delay = static_cast<double>(setting.initial_delay);
+    for (std::uint32_t i = 0;
+         i < reconnect_failures_ && delay < setting.max_delay;
+         ++i) {
+        delay *= setting.multiplier;
+    }
+    delay = std::min(delay, static_cast<double>(setting.max_delay));
+    std::uniform_real_distribution<double> distribution(0.0, setting.jitter);
+    delay *= 1.0 - distribution(reconnect_random_);
+
+    ++reconnect_failures_;
+    receive_message_ = nullptr;
+    replay_queue_.clear();
+    if (setting.retain_queue && sending_ != nullptr
+        && sending_->stream == nullptr) {
+        // start the interrupted message over on the next connection
+        resend_ = std::move(sending_);
+    }
+    sending_ = nullptr;
+    if (!setting.retain_queue) {
+        resend_ = nullptr;
+        message_queue_.drain(batch_);
+        for (; batch_next_ < batch_.size(); batch_next_++) {
+            dequeued_(batch_[batch_next_]);
+        }
+        batch_.clear();
+        batch_next_ = 0;
+    }
+
+    reconnect_pending_ = true;
+    lws_sul_schedule(ws_context_,
+                     0,
+                     &reconnect_timer_.sul,
+                     lws_client_reconnect,
+                     static_cast<lws_usec_t>(delay * 1000.0));
+    return true;
+}
+
+void Client::ClientImpl::schedule_keepalive_(const std::uint32_t& delay) {
+    lws_sul_schedule(ws_context_,
+                     0,
+                     &keepalive_timer_.sul,
+                     lws_client_keepalive,
+                     static_cast<lws_usec_t>(delay) * 1000);
+}
+
+void Client::ClientImpl::stop_keepalive_() {
+    lws_sul_cancel(&keepalive_timer_.sul);
+    ping_due_ = false;
+    ping_outstanding_ = false;
+}
+
+void Client::ClientImpl::enqueued_(const OutgoingMessage& message) {
+    const std::uint64_t length =
+        message.stream == nullptr ? message.message.length() : 0;
+    queued_messages_.fetch_add(1, std::memory_order_relaxed);
+    const std::uint64_t queued =
+        queued_bytes_.fetch_add(length, std::memory_order_relaxed) + length;
+    std::uint64_t peak = peak_queued_bytes_.load(std::memory_order_relaxed);
+    while (queued > peak
+           && !peak_queued_bytes_.compare_exchange_weak(
+               peak, queued, std::memory_order_relaxed)) {}
+}
+
+void Client::ClientImpl::dequeued_(const OutgoingMessage& message) {
+    queued_messages_.fetch_sub(1, std::memory_order_relaxed);
+    queued_bytes_.fetch_sub(
+        message.stream == nullptr ? message.message.length() : 0,
+        std::memory_order_relaxed);
+}
+
+Client::ClientImpl::CallbackTimer::CallbackTimer(ClientImpl& client_impl) :
+    client_impl(client_impl), start(std::chrono::steady_clock::now()) {}
+
+Client::ClientImpl::CallbackTimer::~CallbackTimer() {
+    client_impl.callbacks_.fetch_add(1, std::memory_order_relaxed);
+    client_impl.callback_nanoseconds_.fetch_add(
+        static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count()),
+        std::memory_order_relaxed);
+}
+
+bool Client::ClientImpl::has_outgoing_() {
+    return sending_ != nullptr || !replay_queue_.empty()
+           || batch_next_ < batch_.size() || !message_queue_.empty();
+}
+
+bool Client::ClientImpl::next_message_() {
+    if (!replay_queue_.empty()) {
+        sending_ =
+            std::make_unique<OutgoingMessage>(std::move(replay_queue_.front()));
+        replay_queue_.pop_front();
+    }
+    else {
+        if (batch_next_ == batch_.size()) {
+            // refill with one lock instead of one per message
+            batch_.clear();
+            batch_next_ = 0;
+            if (message_queue_.drain(batch_, SEND_BATCH_SIZE) == 0) {
+                return false;
+            }
+        }
+        sending_ = std::make_unique<OutgoingMessage>(
+            std::move(batch_[batch_next_++]));
+        dequeued_(*sending_);
+    }
+    sending_offset_ = 0;
+    sending_first_ = true;
+    deflate_message_ =
+        deflate_setting_ != nullptr
+        && (sending_->stream != nullptr
+            || sending_->message.length() >= deflate_setting_->min_length);
+    return true;
+}
+
+int Client::ClientImpl::write_fragment_(lws* wsi) {
+    OutgoingMessage& outgoing = *sending_;
+    std::size_t capacity = fragment_size_;
+    if (capacity == 0) {
+        capacity = outgoing.stream != nullptr
+                       ? DEFAULT_FRAGMENT_SIZE
+                       : outgoing.message.length() - sending_offset_;
+    }
+    if (send_buffer_.size() < LWS_PRE + capacity) {
+        send_buffer_.resize(LWS_PRE + capacity);
+    }
+    unsigned char* payload = send_buffer_.data() + LWS_PRE;
+
+    std::size_t length = 0;
+    bool final = false;
+    if (outgoing.stream != nullptr && released_) {
+        // the Client is gone, end the stream without asking it
+        final = true;
+    }
+    else if (outgoing.stream != nullptr) {
+        CallbackTimer timer(*this);
+        length =
+            std::min(outgoing.stream(client_, payload, capacity, final), capacity);
+        if (length == 0 && !final) {
+            // not ready, an empty continuation frame would only spin the
+            // service thread and flood the peer
+            stream_backoff_ =
+                stream_backoff_ == 0
+                    ? 1
+                    : std::min(stream_backoff_ * 2, STREAM_RETRY_MAX_MS);
+            lws_sul_schedule(ws_context_,
+                             0,
+                             &stream_timer_.sul,
+                             lws_client_stream_retry,
+                             static_cast<lws_usec_t>(stream_backoff_) * 1000);
+            return 1;
+        }
+        stream_backoff_ = 0;
+    }
+    else {
+        const std::size_t remaining =
+            outgoing.message.length() - sending_offset_;
+        length = std::min(remaining, capacity);
+        std::memcpy(payload, outgoing.message.data() + sending_offset_, length);
+        final = length == remaining;
+    }
+
+    int protocol = LWS_WRITE_CONTINUATION;
+    if (sending_first_) {
+        protocol = outgoing.message.type() == Message::Type::BINARY
+                       ? LWS_WRITE_BINARY
+                       : LWS_WRITE_TEXT;
+    }
+    if (!final) {
+        protocol |= LWS_WRITE_NO_FIN;
+    }
+    if (lws_write(wsi,
+                  payload,
+                  length,
+                  static_cast<lws_write_protocol>(protocol))
+        < 0) {
+        return -1;
+    }
+    frames_out_.fetch_add(1, std::memory_order_relaxed);
+    bytes_out_.fetch_add(length, std::memory_order_relaxed);
+    if (lws_send_pipe_choked(wsi) != 0) {
+        partial_writes_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    sending_offset_ += length;
+    sending_first_ = false;
+    if (final) {
+        messages_out_.fetch_add(1, std::memory_order_relaxed);
+        sending_ = nullptr;
+    }
+    return 0;
+}
+
+void Client::ClientImpl::stop_stream_retry_() {
+    lws_sul_cancel(&stream_timer_.sul);
+    stream_backoff_ = 0;
+}
+
+void Client::ClientImpl::form_deflate_offer_() {
+    deflate_offer_ = LWS_DEFLATE_EXTENSION_NAME;
+    if (deflate_setting_->server_no_context_takeover) {
+        deflate_offer_ += "; server_no_context_takeover";
+    }
+    if (deflate_setting_->client_no_context_takeover) {
+        deflate_offer_ += "; client_no_context_takeover";
+    }
+    if (deflate_setting_->server_max_window_bits != 0) {
+        deflate_offer_ += "; server_max_window_bits=";
+        deflate_offer_ +=
+            std::to_string(deflate_setting_->server_max_window_bits);
+    }
+    // tell the server we are able to handle client_max_window_bits
+    deflate_offer_ += "; client_max_window_bits";
+    if (deflate_setting_->client_max_window_bits != 0) {
+        deflate_offer_ += '=';
+        deflate_offer_ +=
+            std::to_string(deflate_setting_->client_max_window_bits);
+    }
+}
+
 void Client::ClientImpl::reset_config_() {
     ws_connection_info_.address = nullptr;
     ws_connection_info_.host = nullptr;
@@ -495,12 +1334,26 @@ int lws_client_callback(lws* wsi,
     switch (reason) {
     case /*  1 */ LWS_CALLBACK_CLIENT_CONNECTION_ERROR: {
         if (client_impl.on_error_ != nullptr) {
-            (*client_impl.on_error_)(
-                client_impl.client_,
-                in == nullptr ? std::string {}
-                              : std::string(reinterpret_cast<char*>(in)));
+            client_impl.dispatch_(
+                [&client_impl,
+                 message = in == nullptr
+                               ? std::string {}
+                               : std::string(reinterpret_cast<char*>(in))]()
+                    -> void {
+                    (*client_impl.on_error_)(client_impl.client_, message);
+                });
         }
-        client_impl.stopped_ = true;
+        client_impl.ws_instance_ = nullptr;
+        client_impl.stop_keepalive_();
+        client_impl.stop_stream_retry_();
+        if (!client_impl.interrupted_) {
+            client_impl.unexpected_closes_.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+        if (client_impl.schedule_reconnect_()) {
+            break;
+        }
+        client_impl.mark_stopped_();
         client_impl.reset_config_();
         break;
     }
@@ -529,10 +1382,16 @@ int lws_client_callback(lws* wsi,
                                           buf.data(),
                                           static_cast<int>(buf.capacity()),
                                           lws_index);
-                client_impl.server_header_->add(
-                    {reinterpret_cast<const char*>(
-                         lws_token_to_string(lws_index)),
-                     std::string(buf.data(), result_len)});
+                // lws spells names like "content-type:"
+                std::string_view name(reinterpret_cast<const char*>(
+                    lws_token_to_string(lws_index)));
+                if (!name.empty() && name.back() == ':') {
+                    name.remove_suffix(1);
+                }
+                if (!client_impl.server_header_->exists(name)) {
+                    (*client_impl.server_header_)[name].assign(buf.data(),
+                                                               result_len);
+                }
             }
             ++index;
         }
@@ -559,66 +1418,167 @@ int lws_client_callback(lws* wsi,
     }
 
     case /*  3 */ LWS_CALLBACK_CLIENT_ESTABLISHED: {
+        client_impl.reconnect_failures_ = 0;
+        if (client_impl.reconnecting_) {
+            client_impl.reconnecting_ = false;
+            client_impl.reconnects_.fetch_add(1, std::memory_order_relaxed);
+            if (client_impl.on_reconnect_ != nullptr
+                && !client_impl.released_) {
+                Client::ClientImpl::CallbackTimer timer(client_impl);
+                for (Message& message :
+                     (*client_impl.on_reconnect_)(client_impl.client_)) {
+                    client_impl.replay_queue_.emplace_back(
+                        OutgoingMessage {std::move(message)});
+                }
+            }
+            if (client_impl.resend_ != nullptr) {
+                client_impl.replay_queue_.emplace_back(
+                    std::move(*client_impl.resend_));
+                client_impl.resend_ = nullptr;
+            }
+        }
+        if (client_impl.keepalive_setting_ != nullptr) {
+            client_impl.schedule_keepalive_(
+                client_impl.keepalive_setting_->ping_interval);
+        }
         if (client_impl.on_establish_ != nullptr) {
-            (*client_impl.on_establish_)(client_impl.client_);
+            client_impl.dispatch_([&client_impl]() -> void {
+                (*client_impl.on_establish_)(client_impl.client_);
+            });
+        }
+        if (client_impl.has_outgoing_()) {
+            // flush messages queued before the connection was established
+            lws_callback_on_writable(wsi);
         }
         break;
     }
 
     case /*  8 */ LWS_CALLBACK_CLIENT_RECEIVE: {
-        if (lws_is_first_fragment(wsi) != 0) {
-            if (lws_frame_is_binary(wsi) != 0) {
-                unsigned char* binary_message =
-                    reinterpret_cast<unsigned char*>(in);
-                client_impl.receive_message_ =
-                    std::make_unique<Message>(std::vector<unsigned char>(
-                        binary_message, binary_message + len));
+        if (client_impl.inflate_message_) {
+            client_impl.original_bytes_in_.fetch_add(
+                len, std::memory_order_relaxed);
+            if (lws_is_final_fragment(wsi) != 0) {
+                client_impl.inflate_message_ = false;
+            }
+        }
+        const bool is_first = lws_is_first_fragment(wsi) != 0;
+        const bool is_final = lws_is_final_fragment(wsi) != 0;
+        client_impl.bytes_in_.fetch_add(len, std::memory_order_relaxed);
+        if (lws_remaining_packet_payload(wsi) == 0) {
+            client_impl.frames_in_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (is_final) {
+            client_impl.messages_in_.fetch_add(1, std::memory_order_relaxed);
+        }
+        unsigned char* data = reinterpret_cast<unsigned char*>(in);
+        if (is_first) {
+            client_impl.receive_type_ = lws_frame_is_binary(wsi) != 0
+                                            ? Message::Type::BINARY
+                                            : Message::Type::TEXT;
+        }
+
+        if (client_impl.on_fragment_ != nullptr) {
+            const Message::Type type = client_impl.receive_type_;
+            if (client_impl.executor_ == nullptr) {
+                // inline, lws' buffer outlives the callback
+                client_impl.dispatch_([&]() -> void {
+                    (*client_impl.on_fragment_)(client_impl.client_,
+                                                Client::Fragment {type, data, len},
+                                                is_first,
+                                                is_final);
+                });
             }
             else {
-                client_impl.receive_message_ = std::make_unique<Message>(
-                    std::string(reinterpret_cast<char*>(in), len));
+                client_impl.dispatch_(
+                    [&client_impl,
+                     type,
+                     copy = std::vector<unsigned char>(data, data + len),
+                     is_first,
+                     is_final]() -> void {
+                        (*client_impl.on_fragment_)(
+                            client_impl.client_,
+                            Client::Fragment {type, copy.data(), copy.size()},
+                            is_first,
+                            is_final);
+                    });
             }
-            if (lws_is_final_fragment(wsi) != 0) {
-                if (client_impl.on_receive_ != nullptr) {
-                    (*client_impl.on_receive_)(client_impl.client_,
-                                               *client_impl.receive_message_);
-                }
+        }
+
+        if (client_impl.on_receive_ == nullptr) {
+            // nobody wants the whole message, do not buffer it
+            client_impl.receive_message_ = nullptr;
+            break;
+        }
+
+        if (is_first) {
+            if (client_impl.receive_type_ == Message::Type::BINARY) {
+                client_impl.receive_message_ = std::make_unique<Message>(
+                    std::vector<unsigned char>(data, data + len));
             }
             else {
+                client_impl.receive_message_ = std::make_unique<Message>(
+                    std::string(reinterpret_cast<char*>(in), len));
+            }
+            if (!is_final) {
                 client_impl.receive_message_->reserve(
                     len + lws_remaining_packet_payload(wsi) + 4);
             }
+        }
+        else if (client_impl.receive_message_ != nullptr) {
+            switch (client_impl.receive_message_->type()) {
+            case Message::Type::BINARY: {
+                std::vector<unsigned char>& binary =
+                    client_impl.receive_message_->binary();
+                binary.insert(binary.end(), data, data + len);
+                break;
+            }
+            case Message::Type::TEXT: {
+                client_impl.receive_message_->text().append(
+                    reinterpret_cast<char*>(in), len);
+                break;
+            }
+            default: break;
+            }
+        }
+        else {
+            // on_receive was set in the middle of a message
             break;
         }
 
-        switch (client_impl.receive_message_->type()) {
-        case Message::Type::BINARY: {
-            unsigned char* binary_message =
-                reinterpret_cast<unsigned char*>(in);
-            std::vector<unsigned char>& binary =
-                client_impl.receive_message_->binary();
-            binary.insert(binary.end(), binary_message, binary_message + len);
-            break;
+        if (is_final) {
+            client_impl.dispatch_(
+                [&client_impl,
+                 message = std::shared_ptr<Message>(
+                     std::move(client_impl.receive_message_))]() -> void {
+                    (*client_impl.on_receive_)(client_impl.client_, *message);
+                });
         }
-        case Message::Type::TEXT: {
-            client_impl.receive_message_->text().append(
-                reinterpret_cast<char*>(in), len);
+
+        break;
+    }
+
+    case /*  9 */ LWS_CALLBACK_CLIENT_RECEIVE_PONG: {
+        std::int64_t sent_at = 0;
+        if (!client_impl.ping_outstanding_ || len != sizeof(sent_at)) {
+            // not the answer to our ping
             break;
         }
-        default: break;
+        std::memcpy(&sent_at, in, sizeof(sent_at));
+        if (sent_at != client_impl.ping_sent_at_) {
+            break;
         }
-
-        if (lws_is_final_fragment(wsi) != 0) {
-            if (client_impl.on_receive_ != nullptr) {
-                (*client_impl.on_receive_)(client_impl.client_,
-                                           *client_impl.receive_message_);
-            }
+        client_impl.ping_outstanding_ = false;
+        client_impl.rtt_.record(
+            static_cast<std::uint64_t>(steady_now() - sent_at) / 1000);
+        if (client_impl.keepalive_setting_ != nullptr) {
+            client_impl.schedule_keepalive_(
+                client_impl.keepalive_setting_->ping_interval);
         }
-
         break;
     }
 
     case /* 10 */ LWS_CALLBACK_CLIENT_WRITEABLE: {
+        client_impl.writable_callbacks_.fetch_add(1, std::memory_order_relaxed);
         if (client_impl.interrupted_) {
             const std::unique_ptr<std::uint16_t>& status =
                 client_impl.local_close_status_;
@@ -642,28 +1602,33 @@ int lws_client_callback(lws* wsi,
                              close_message_length);
             return -1;
         }
-        if (client_impl.new_message_) {
-            Message& message = client_impl.message_queue_.front();
-            switch (message.type()) {
-            case Message::Type::BINARY:
-                lws_write(wsi,
-                          reinterpret_cast<unsigned char*>(message.data()),
-                          message.length(),
-                          LWS_WRITE_BINARY);
-                break;
-            case Message::Type::TEXT:
-                lws_write(wsi,
-                          reinterpret_cast<unsigned char*>(message.data()),
-                          message.length(),
-                          LWS_WRITE_TEXT);
-                break;
-            default: break;
+        if (client_impl.ping_due_) {
+            std::int64_t sent_at = steady_now();
+            unsigned char ping[LWS_PRE + sizeof(sent_at)];
+            std::memcpy(ping + LWS_PRE, &sent_at, sizeof(sent_at));
+            if (lws_write(wsi, ping + LWS_PRE, sizeof(sent_at), LWS_WRITE_PING)
+                < 0) {
+                return -1;
             }
-            client_impl.message_queue_.pop();
-            client_impl.new_message_ = !client_impl.message_queue_.empty();
-            if (client_impl.new_message_) {
+            client_impl.ping_due_ = false;
+            client_impl.ping_outstanding_ = true;
+            client_impl.ping_sent_at_ = sent_at;
+            if (client_impl.has_outgoing_()) {
                 lws_callback_on_writable(wsi);
             }
+            break;
+        }
+        if (client_impl.sending_ == nullptr && !client_impl.next_message_()) {
+            break;
+        }
+        // one frame at a time, so large messages do not hold the service
+        // thread and control frames can go in between
+        const int written = client_impl.write_fragment_(wsi);
+        if (written < 0) {
+            return -1;
+        }
+        if (written == 0 && client_impl.has_outgoing_()) {
+            lws_callback_on_writable(wsi);
         }
         break;
     }
@@ -673,16 +1638,15 @@ int lws_client_callback(lws* wsi,
             if (client_impl.header_ == nullptr) {
                 client_impl.header_ = std::make_unique<general::Header>();
             }
-            client_impl.header_->update(
-                {"Cookie", client_impl.cookie_->c_str()});
+            (*client_impl.header_)[general::HeaderId::COOKIE] =
+                client_impl.cookie_->c_str();
         }
         else if (client_impl.header_ == nullptr) {
             break;
         }
         unsigned char** p = reinterpret_cast<unsigned char**>(in);
         unsigned char* end = (*p) + len;
-        for (const std::pair<const std::string, std::string>& header :
-             *client_impl.header_) {
+        for (const auto& header : *client_impl.header_) {
             const std::size_t name_length = header.first.length();
             char name[name_length + 2];
             header.first.copy(name, name_length);
@@ -720,37 +1684,207 @@ int lws_client_callback(lws* wsi,
 
     case /* 75 */ LWS_CALLBACK_CLIENT_CLOSED: {
         if (client_impl.on_close_ != nullptr) {
-            if (client_impl.close_status_ == nullptr) {
-                (*client_impl.on_close_)(
-                    client_impl.client_,
-                    static_cast<CloseStatus>(CloseStatus::ABNORMAL),
-                    std::string {});
-            }
-            else {
-                (*client_impl.on_close_)(
-                    client_impl.client_,
-                    static_cast<CloseStatus>(*client_impl.close_status_),
-                    *client_impl.close_message_);
+            CloseStatus close_status(CloseStatus::ABNORMAL);
+            std::string close_message;
+            if (client_impl.close_status_ != nullptr) {
+                close_status = *client_impl.close_status_;
+                close_message = *client_impl.close_message_;
             }
+            client_impl.dispatch_(
+                [&client_impl, close_status, close_message]() -> void {
+                    (*client_impl.on_close_)(
+                        client_impl.client_, close_status, close_message);
+                });
+        }
+        client_impl.ws_instance_ = nullptr;
+        client_impl.stop_keepalive_();
+        client_impl.stop_stream_retry_();
+        client_impl.close_status_ = nullptr;
+        client_impl.close_message_ = nullptr;
+        if (!client_impl.interrupted_) {
+            client_impl.unexpected_closes_.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+        if (client_impl.schedule_reconnect_()) {
+            break;
         }
-        client_impl.stopped_ = true;
+        client_impl.mark_stopped_();
         client_impl.reset_config_();
         break;
     }
 
+    case /* 71 */ LWS_CALLBACK_EVENT_WAIT_CANCELLED: {
+        // woken up by wake_lws_up_(), wsi is not the client connection here
+        if (client_impl.reconnect_pending_ && client_impl.interrupted_) {
+            // disconnected while waiting to reconnect
+            lws_sul_cancel(&client_impl.reconnect_timer_.sul);
+            client_impl.reconnect_pending_ = false;
+            client_impl.mark_stopped_();
+            client_impl.reset_config_();
+            break;
+        }
+        if (client_impl.ws_instance_ != nullptr
+            && (client_impl.interrupted_ || client_impl.has_outgoing_())) {
+            lws_callback_on_writable(client_impl.ws_instance_);
+        }
+        break;
+    }
+
     default: break;
     }
 
     return 0;
 }
 
+void lws_client_reconnect(lws_sorted_usec_list_t* sul) {
+    Client::ClientImpl& client_impl =
+        *reinterpret_cast<LwsClientTimer*>(sul)->client_impl;
+    client_impl.reconnect_pending_ = false;
+    if (client_impl.interrupted_) {
+        client_impl.mark_stopped_();
+        client_impl.reset_config_();
+        return;
+    }
+    client_impl.reconnect_attempts_.fetch_add(1, std::memory_order_relaxed);
+    client_impl.reconnecting_ = true;
+    if (lws_client_connect_via_info(&client_impl.ws_connection_info_)
+            == nullptr
+        && !client_impl.reconnect_pending_
+        && !client_impl.schedule_reconnect_()) {
+        // failed before lws could report LWS_CALLBACK_CLIENT_CONNECTION_ERROR
+        client_impl.mark_stopped_();
+        client_impl.reset_config_();
+    }
+}
+
+void lws_client_stream_retry(lws_sorted_usec_list_t* sul) {
+    Client::ClientImpl& client_impl =
+        *reinterpret_cast<LwsClientTimer*>(sul)->client_impl;
+    if (client_impl.ws_instance_ != nullptr) {
+        lws_callback_on_writable(client_impl.ws_instance_);
+    }
+}
+
+void lws_client_keepalive(lws_sorted_usec_list_t* sul) {
+    Client::ClientImpl& client_impl =
+        *reinterpret_cast<LwsClientTimer*>(sul)->client_impl;
+    if (client_impl.ws_instance_ == nullptr
+        || client_impl.keepalive_setting_ == nullptr) {
+        return;
+    }
+    const std::uint32_t pong_timeout =
+        client_impl.keepalive_setting_->pong_timeout;
+    if (client_impl.ping_outstanding_) {
+        const std::int64_t waited =
+            (steady_now() - client_impl.ping_sent_at_) / 1000000;
+        if (waited < pong_timeout) {
+            client_impl.schedule_keepalive_(
+                static_cast<std::uint32_t>(pong_timeout - waited));
+            return;
+        }
+        // half-open connection, let lws close it as if the server did
+        client_impl.pong_timeouts_.fetch_add(1, std::memory_order_relaxed);
+        client_impl.ping_outstanding_ = false;
+        lws_set_timeout(
+            client_impl.ws_instance_, PENDING_TIMEOUT_USER_OK, LWS_TO_KILL_ASYNC);
+        return;
+    }
+    client_impl.ping_due_ = true;
+    lws_callback_on_writable(client_impl.ws_instance_);
+    client_impl.schedule_keepalive_(pong_timeout);
+}
+
+int lws_client_deflate_callback(lws_context* context,
+                                const lws_extension* ext,
+                                lws* wsi,
+                                lws_extension_callback_reasons reason,
+                                void* user,
+                                void* in,
+                                std::size_t len) {
+    switch (reason) {
+    case /* 21 */ LWS_EXT_CB_PAYLOAD_TX: {
+        Client::ClientImpl& client_impl =
+            *reinterpret_cast<Client::ClientImpl*>(
+                lws_context_user(lws_get_context(wsi)));
+        if (!client_impl.deflate_message_) {
+            // not worth compressing, the frame goes out with RSV1 unset
+            return 0;
+        }
+        lws_ext_pm_deflate_rx_ebufs& ebufs =
+            *reinterpret_cast<lws_ext_pm_deflate_rx_ebufs*>(in);
+        const int consumed = ebufs.eb_in.len;
+        const int result = lws_extension_callback_pm_deflate(
+            context, ext, wsi, reason, user, in, len);
+        if (result >= 0) {
+            client_impl.original_bytes_out_.fetch_add(
+                consumed - ebufs.eb_in.len, std::memory_order_relaxed);
+            client_impl.compressed_bytes_out_.fetch_add(
+                ebufs.eb_out.len, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    case /* 22 */ LWS_EXT_CB_PAYLOAD_RX: {
+        Client::ClientImpl& client_impl =
+            *reinterpret_cast<Client::ClientImpl*>(
+                lws_context_user(lws_get_context(wsi)));
+        lws_ext_pm_deflate_rx_ebufs& ebufs =
+            *reinterpret_cast<lws_ext_pm_deflate_rx_ebufs*>(in);
+        const int available = ebufs.eb_in.len;
+        const int result = lws_extension_callback_pm_deflate(
+            context, ext, wsi, reason, user, in, len);
+        if (result >= 0 && available > ebufs.eb_in.len) {
+            // inflated bytes are counted in LWS_CALLBACK_CLIENT_RECEIVE
+            client_impl.compressed_bytes_in_.fetch_add(
+                available - ebufs.eb_in.len, std::memory_order_relaxed);
+            client_impl.inflate_message_ = true;
+        }
+        return result;
+    }
+
+    default:
+        return lws_extension_callback_pm_deflate(
+            context, ext, wsi, reason, user, in, len);
+    }
+}
+
+const std::size_t Client::DEFAULT_FRAGMENT_SIZE = 64 * 1024;
+
+double Client::Stats::compression_ratio_in() const {
+    if (original_bytes_in == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(compressed_bytes_in)
+           / static_cast<double>(original_bytes_in);
+}
+
+double Client::Stats::compression_ratio_out() const {
+    if (original_bytes_out == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(compressed_bytes_out)
+           / static_cast<double>(original_bytes_out);
+}
+
 Client::Client() {
-    impl_ = std::make_unique<ClientImpl>(*this);
+    impl_ = std::make_shared<ClientImpl>(*this);
 }
 
 Client::Client(Client&&) noexcept = default;
-Client& Client::operator=(Client&&) noexcept = default;
-Client::~Client() = default;
+
+Client& Client::operator=(Client&& client) noexcept {
+    if (impl_ != nullptr && impl_ != client.impl_) {
+        impl_->release();
+    }
+    impl_ = std::move(client.impl_);
+    return *this;
+}
+
+Client::~Client() {
+    if (impl_ != nullptr) {
+        impl_->release();
+    }
+}
 
 Client& Client::connect() {
     impl_->connect();
@@ -794,6 +1928,26 @@ Client& Client::disconnect(const std::string& message,
     return *this;
 }
 
+void Client::disconnect_all(const std::vector<Client*>& clients) {
+    for (Client* client : clients) {
+        client->impl_->request_disconnect();
+    }
+    for (Client* client : clients) {
+        client->impl_->wait_disconnected();
+    }
+}
+
+void Client::disconnect_all(const std::vector<Client*>& clients,
+                            const std::string& message,
+                            const CloseStatus& close_status) {
+    for (Client* client : clients) {
+        client->impl_->request_disconnect(message, close_status.value());
+    }
+    for (Client* client : clients) {
+        client->impl_->wait_disconnected();
+    }
+}
+
 bool Client::connected() const {
     return impl_->connected();
 }
@@ -897,6 +2051,57 @@ const std::unique_ptr<Client::ErrorCallback>& Client::on_error() {
     return impl_->on_error();
 }
 
+const std::unique_ptr<Client::DeflateSetting>& Client::deflate_setting() {
+    return impl_->deflate_setting();
+}
+
+Client& Client::deflate_setting(const DeflateSetting& deflate_setting) {
+    impl_->deflate_setting(deflate_setting);
+    return *this;
+}
+
+Client& Client::deflate_setting(std::nullptr_t) {
+    impl_->deflate_setting(nullptr);
+    return *this;
+}
+
+const std::size_t& Client::fragment_size() const {
+    return impl_->fragment_size();
+}
+
+Client& Client::fragment_size(const std::size_t& fragment_size) {
+    impl_->fragment_size(fragment_size);
+    return *this;
+}
+
+const std::unique_ptr<Client::KeepaliveSetting>& Client::keepalive_setting() {
+    return impl_->keepalive_setting();
+}
+
+Client& Client::keepalive_setting(const KeepaliveSetting& keepalive_setting) {
+    impl_->keepalive_setting(keepalive_setting);
+    return *this;
+}
+
+Client& Client::keepalive_setting(std::nullptr_t) {
+    impl_->keepalive_setting(nullptr);
+    return *this;
+}
+
+const std::unique_ptr<Client::ReconnectSetting>& Client::reconnect_setting() {
+    return impl_->reconnect_setting();
+}
+
+Client& Client::reconnect_setting(const ReconnectSetting& reconnect_setting) {
+    impl_->reconnect_setting(reconnect_setting);
+    return *this;
+}
+
+Client& Client::reconnect_setting(std::nullptr_t) {
+    impl_->reconnect_setting(nullptr);
+    return *this;
+}
+
 Client& Client::on_error(const ErrorCallback& callback) {
     impl_->on_error(callback);
     return *this;
@@ -950,6 +2155,25 @@ Client& Client::on_receive(std::nullptr_t) {
     return *this;
 }
 
+const std::unique_ptr<Client::FragmentCallback>& Client::on_fragment() {
+    return impl_->on_fragment();
+}
+
+Client& Client::on_fragment(const FragmentCallback& callback) {
+    impl_->on_fragment(callback);
+    return *this;
+}
+
+Client& Client::on_fragment(FragmentCallback&& callback) {
+    impl_->on_fragment(std::move(callback));
+    return *this;
+}
+
+Client& Client::on_fragment(std::nullptr_t) {
+    impl_->on_fragment(nullptr);
+    return *this;
+}
+
 const std::unique_ptr<Client::CloseCallback>& Client::on_close() {
     return impl_->on_close();
 }
@@ -969,6 +2193,25 @@ Client& Client::on_close(std::nullptr_t) {
     return *this;
 }
 
+const std::unique_ptr<Client::ReconnectCallback>& Client::on_reconnect() {
+    return impl_->on_reconnect();
+}
+
+Client& Client::on_reconnect(const ReconnectCallback& callback) {
+    impl_->on_reconnect(callback);
+    return *this;
+}
+
+Client& Client::on_reconnect(ReconnectCallback&& callback) {
+    impl_->on_reconnect(std::move(callback));
+    return *this;
+}
+
+Client& Client::on_reconnect(std::nullptr_t) {
+    impl_->on_reconnect(nullptr);
+    return *this;
+}
+
 Client& Client::send(const Message& message) {
     impl_->send(message);
     return *this;
@@ -979,4 +2222,55 @@ Client& Client::send(Message&& message) {
     return *this;
 }
 
+Client& Client::send_stream(const Message::Type& type,
+                            const StreamCallback& callback) {
+    impl_->send_stream(type, StreamCallback(callback));
+    return *this;
+}
+
+Client& Client::send_stream(const Message::Type& type,
+                            StreamCallback&& callback) {
+    impl_->send_stream(type, std::move(callback));
+    return *this;
+}
+
+Client::Stats Client::stats() const {
+    return impl_->stats();
+}
+
+const misc::Histogram& Client::rtt() const {
+    return impl_->rtt();
+}
+
+const misc::Histogram& Client::delivery_latency() const {
+    return impl_->delivery_latency();
+}
+
+Client::Executor Client::thread_pool(const std::size_t& threads) {
+    std::shared_ptr<misc::ThreadPool> pool =
+        std::make_shared<misc::ThreadPool>(threads);
+    return [pool](std::function<void()> task) -> void {
+        pool->post(std::move(task));
+    };
+}
+
+const std::unique_ptr<Client::Executor>& Client::executor() {
+    return impl_->executor();
+}
+
+Client& Client::executor(const Executor& executor) {
+    impl_->executor(executor);
+    return *this;
+}
+
+Client& Client::executor(Executor&& executor) {
+    impl_->executor(std::move(executor));
+    return *this;
+}
+
+Client& Client::executor(std::nullptr_t) {
+    impl_->executor(nullptr);
+    return *this;
+}
+
 } // namespace rayalto::utils::network::websocket
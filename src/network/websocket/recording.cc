@@ -0,0 +1,206 @@
+#include "rautils/network/websocket/recording.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rautils/exceptions/exceptions.h"
+#include "rautils/network/websocket/message.h"
+
+namespace rayalto::utils::network::websocket {
+
+namespace {
+
+constexpr char RECORDING_MAGIC[] = {'R', 'A', 'W', 'S', 'R', 'E', 'C', 0x01};
+
+void write_varint(std::ostream& stream, std::uint64_t value) {
+    char bytes[10];
+    std::size_t length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = static_cast<char>(value);
+    stream.write(bytes, static_cast<std::streamsize>(length));
+}
+
+// return false if the buffer ends in the middle of the varint
+bool read_varint(const std::vector<char>& buffer,
+                 std::size_t& offset,
+                 std::uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && offset < buffer.size();
+         shift += 7) {
+        const std::uint8_t byte = static_cast<std::uint8_t>(buffer[offset++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void write_entry(std::ostream& stream,
+                 const std::uint64_t& delay,
+                 const Message& message) {
+    write_varint(stream, delay);
+    stream.put(static_cast<char>(message.type()));
+    write_varint(stream, message.length());
+    if (message.type() == Message::Type::BINARY) {
+        stream.write(reinterpret_cast<const char*>(message.binary().data()),
+                     static_cast<std::streamsize>(message.length()));
+    }
+    else {
+        stream.write(message.text().data(),
+                     static_cast<std::streamsize>(message.length()));
+    }
+}
+
+} // namespace
+
+Recording Recording::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw exceptions::Exception(
+            "RecordingError", "Recording::load()", "Cannot open " + path);
+    }
+    const std::vector<char> buffer {std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>()};
+    if (buffer.size() < sizeof(RECORDING_MAGIC)
+        || std::memcmp(buffer.data(), RECORDING_MAGIC, sizeof(RECORDING_MAGIC))
+               != 0) {
+        throw exceptions::Exception(
+            "RecordingError", "Recording::load()", path + " is not a recording");
+    }
+
+    Recording recording;
+    std::uint64_t timestamp = 0;
+    std::size_t offset = sizeof(RECORDING_MAGIC);
+    while (offset < buffer.size()) {
+        std::uint64_t delay = 0;
+        std::uint64_t length = 0;
+        if (!read_varint(buffer, offset, delay) || offset >= buffer.size()) {
+            break;
+        }
+        const auto raw_type = static_cast<std::uint8_t>(buffer[offset++]);
+        if (raw_type != static_cast<std::uint8_t>(Message::Type::TEXT)
+            && raw_type != static_cast<std::uint8_t>(Message::Type::BINARY)) {
+            throw exceptions::Exception(
+                "RecordingError",
+                "Recording::load()",
+                path + " is malformed, unknown message type "
+                    + std::to_string(raw_type));
+        }
+        const auto type = static_cast<Message::Type>(raw_type);
+        if (!read_varint(buffer, offset, length)
+            || length > buffer.size() - offset) {
+            break;
+        }
+        timestamp += delay;
+        const char* payload = buffer.data() + offset;
+        if (type == Message::Type::BINARY) {
+            recording.add(timestamp,
+                          Message(std::vector<unsigned char>(payload,
+                                                             payload + length)));
+        }
+        else {
+            recording.add(timestamp, Message(std::string(payload, length)));
+        }
+        offset += length;
+    }
+    if (offset != buffer.size()) {
+        throw exceptions::Exception(
+            "RecordingError", "Recording::load()", path + " is truncated");
+    }
+    return recording;
+}
+
+void Recording::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw exceptions::Exception(
+            "RecordingError", "Recording::save()", "Cannot open " + path);
+    }
+    file.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    std::uint64_t last_timestamp = 0;
+    for (const Entry& entry : entries_) {
+        write_entry(file, entry.timestamp - last_timestamp, entry.message);
+        last_timestamp = entry.timestamp;
+    }
+    if (!file) {
+        throw exceptions::Exception(
+            "RecordingError", "Recording::save()", "Cannot write " + path);
+    }
+}
+
+const std::vector<Recording::Entry>& Recording::entries() const {
+    return entries_;
+}
+
+std::vector<Recording::Entry>& Recording::entries() {
+    return entries_;
+}
+
+Recording& Recording::add(const std::uint64_t& timestamp,
+                          const Message& message) {
+    entries_.push_back(Entry {timestamp, message});
+    return *this;
+}
+
+Recording& Recording::add(const std::uint64_t& timestamp, Message&& message) {
+    entries_.push_back(Entry {timestamp, std::move(message)});
+    return *this;
+}
+
+std::size_t Recording::size() const {
+    return entries_.size();
+}
+
+bool Recording::empty() const {
+    return entries_.empty();
+}
+
+std::uint64_t Recording::duration() const {
+    return entries_.empty() ? 0 : entries_.back().timestamp;
+}
+
+Recorder::Recorder(const std::string& path) :
+    file_(path, std::ios::binary | std::ios::trunc) {
+    if (!file_) {
+        throw exceptions::Exception(
+            "RecordingError", "Recorder::Recorder()", "Cannot open " + path);
+    }
+    file_.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+}
+
+Recorder& Recorder::record(const Message& message) {
+    const auto now = std::chrono::steady_clock::now();
+    if (count_ == 0) {
+        start_ = now;
+    }
+    const auto timestamp = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - start_)
+            .count());
+    write_entry(file_, timestamp - last_timestamp_, message);
+    last_timestamp_ = timestamp;
+    ++count_;
+    return *this;
+}
+
+Recorder& Recorder::flush() {
+    file_.flush();
+    return *this;
+}
+
+const std::size_t& Recorder::count() const {
+    return count_;
+}
+
+} // namespace rayalto::utils::network::websocket
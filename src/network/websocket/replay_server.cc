@@ -0,0 +1,328 @@
+#include "rautils/network/websocket/replay_server.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "libwebsockets.h"
+
+#include "rautils/exceptions/exceptions.h"
+#include "rautils/network/websocket/message.h"
+#include "rautils/network/websocket/recording.h"
+
+namespace rayalto::utils::network::websocket {
+
+namespace {
+
+constexpr const char* LWS_REPLAY_PROTOCOL_NAME = "ra-utils-replay";
+
+} // namespace
+
+struct ReplaySession;
+
+// lws_sorted_usec_list_t has to be the first member
+struct LwsReplayTimer {
+    lws_sorted_usec_list_t sul;
+    ReplaySession* session;
+};
+
+// a connected client, only touched by the service thread
+struct ReplaySession {
+    lws* wsi = nullptr;
+    LwsReplayTimer timer {{}, this};
+    std::chrono::steady_clock::time_point start;
+    // index of the next entry to send
+    std::size_t next = 0;
+};
+
+int lws_replay_callback(lws* wsi,
+                        lws_callback_reasons reason,
+                        void* user,
+                        void* in,
+                        std::size_t len);
+
+void lws_replay_resume(lws_sorted_usec_list_t* sul);
+
+class ReplayServer::ReplayServerImpl {
+public:
+    friend int lws_replay_callback(lws* wsi,
+                                   lws_callback_reasons reason,
+                                   void* user,
+                                   void* in,
+                                   std::size_t len);
+
+    explicit ReplayServerImpl(Recording&& recording);
+    ReplayServerImpl() = delete;
+
+    // Impl does not need these
+    ReplayServerImpl(const ReplayServerImpl&) = delete;
+    ReplayServerImpl(ReplayServerImpl&&) noexcept = delete;
+    ReplayServerImpl& operator=(const ReplayServerImpl&) = delete;
+    ReplayServerImpl& operator=(ReplayServerImpl&&) noexcept = delete;
+
+    virtual ~ReplayServerImpl();
+
+    [[nodiscard]] double speed() const;
+    void speed(const double& speed);
+
+    void start(const std::uint16_t& port);
+    void stop();
+
+    [[nodiscard]] bool running() const;
+    [[nodiscard]] std::uint64_t sent() const;
+
+protected:
+    /* libwebsockets stuff */
+    lws_context* ws_context_ = nullptr;
+    lws_context_creation_info ws_context_info_ {};
+    lws_protocols ws_protocols_[2] {
+        {LWS_REPLAY_PROTOCOL_NAME, lws_replay_callback, 0, 0, 0, nullptr, 0},
+        LWS_PROTOCOL_LIST_TERM};
+
+    std::unique_ptr<std::thread> work_thread_ = nullptr;
+    // guards ws_context_ between lws_cancel_service and taking it away
+    std::mutex wake_lws_;
+    std::atomic<bool> stopped_ = true;
+    std::atomic<std::uint64_t> sent_ = 0;
+
+    /* configuration */
+    const Recording recording_;
+    // may be changed from any thread while the service thread reads it
+    std::atomic<double> speed_ = 0.0;
+
+    /* only touched by the service thread */
+    std::unordered_map<lws*, std::unique_ptr<ReplaySession>> sessions_;
+    // LWS_PRE bytes of header room followed by the payload
+    std::vector<unsigned char> send_buffer_;
+
+    // send the next entry of `session` if it is due, return -1 to close
+    int write_next_(ReplaySession& session);
+};
+
+ReplayServer::ReplayServerImpl::ReplayServerImpl(Recording&& recording) :
+    recording_(std::move(recording)) {
+    lws_set_log_level(0, lwsl_emit_syslog);
+    ws_context_info_.iface = "127.0.0.1";
+    ws_context_info_.protocols = ws_protocols_;
+    // pass the this pointer to lws_callback
+    ws_context_info_.user = this;
+}
+
+ReplayServer::ReplayServerImpl::~ReplayServerImpl() {
+    stop();
+}
+
+double ReplayServer::ReplayServerImpl::speed() const {
+    return speed_.load(std::memory_order_relaxed);
+}
+
+void ReplayServer::ReplayServerImpl::speed(const double& speed) {
+    speed_.store(speed < 0.0 ? 0.0 : speed, std::memory_order_relaxed);
+}
+
+void ReplayServer::ReplayServerImpl::start(const std::uint16_t& port) {
+    stop();
+    ws_context_info_.port = port;
+    ws_context_ = lws_create_context(&ws_context_info_);
+    if (ws_context_ == nullptr) {
+        throw exceptions::Exception(
+            "LwsError",
+            "ReplayServer::start()",
+            "Failed to listen on port " + std::to_string(port));
+    }
+    stopped_ = false;
+    work_thread_ = std::make_unique<std::thread>([&]() -> void {
+        int status = 0;
+        while (status >= 0 && !stopped_) {
+            status = lws_service(ws_context_, 0);
+        }
+        // sessions die with the context
+        for (auto& [wsi, session] : sessions_) {
+            lws_sul_cancel(&session->timer.sul);
+        }
+        sessions_.clear();
+        lws_context* context = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(wake_lws_);
+            std::swap(context, ws_context_);
+        }
+        // outside wake_lws_, so the callbacks fired by the destruction do
+        // not run with it held
+        lws_context_destroy(context);
+        stopped_ = true;
+    });
+}
+
+void ReplayServer::ReplayServerImpl::stop() {
+    if (work_thread_ == nullptr) {
+        return;
+    }
+    stopped_ = true;
+    {
+        std::lock_guard<std::mutex> lock(wake_lws_);
+        if (ws_context_ != nullptr) {
+            lws_cancel_service(ws_context_);
+        }
+    }
+    work_thread_->join();
+    work_thread_ = nullptr;
+}
+
+bool ReplayServer::ReplayServerImpl::running() const {
+    return !stopped_;
+}
+
+std::uint64_t ReplayServer::ReplayServerImpl::sent() const {
+    return sent_.load(std::memory_order_relaxed);
+}
+
+int ReplayServer::ReplayServerImpl::write_next_(ReplaySession& session) {
+    const std::vector<Recording::Entry>& entries = recording_.entries();
+    if (session.next >= entries.size()) {
+        lws_close_reason(session.wsi, LWS_CLOSE_STATUS_NORMAL, nullptr, 0);
+        return -1;
+    }
+    const Recording::Entry& entry = entries[session.next];
+
+    const double speed = speed_.load(std::memory_order_relaxed);
+    if (speed > 0.0) {
+        const auto due =
+            session.start
+            + std::chrono::microseconds(static_cast<std::int64_t>(
+                static_cast<double>(entry.timestamp) / speed));
+        const auto now = std::chrono::steady_clock::now();
+        if (now < due) {
+            lws_sul_schedule(
+                ws_context_,
+                0,
+                &session.timer.sul,
+                lws_replay_resume,
+                std::chrono::duration_cast<std::chrono::microseconds>(due
+                                                                      - now)
+                    .count());
+            return 0;
+        }
+    }
+
+    const Message& message = entry.message;
+    const std::size_t length = message.length();
+    if (send_buffer_.size() < LWS_PRE + length) {
+        send_buffer_.resize(LWS_PRE + length);
+    }
+    unsigned char* payload = send_buffer_.data() + LWS_PRE;
+    lws_write_protocol protocol = LWS_WRITE_TEXT;
+    if (message.type() == Message::Type::BINARY) {
+        std::memcpy(payload, message.binary().data(), length);
+        protocol = LWS_WRITE_BINARY;
+    }
+    else {
+        std::memcpy(payload, message.text().data(), length);
+    }
+    if (lws_write(session.wsi, payload, length, protocol) < 0) {
+        return -1;
+    }
+    ++session.next;
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    lws_callback_on_writable(session.wsi);
+    return 0;
+}
+
+int lws_replay_callback(lws* wsi,
+                        lws_callback_reasons reason,
+                        void* /* user */,
+                        void* /* in */,
+                        std::size_t /* len */) {
+    lws_context* context = lws_get_context(wsi);
+    if (context == nullptr) {
+        return 0;
+    }
+    auto* server_impl = reinterpret_cast<ReplayServer::ReplayServerImpl*>(
+        lws_context_user(context));
+    if (server_impl == nullptr) {
+        return 0;
+    }
+    ReplayServer::ReplayServerImpl& impl = *server_impl;
+
+    switch (reason) {
+    case /*  0 */ LWS_CALLBACK_ESTABLISHED: {
+        auto session = std::make_unique<ReplaySession>();
+        session->wsi = wsi;
+        session->start = std::chrono::steady_clock::now();
+        impl.sessions_[wsi] = std::move(session);
+        lws_callback_on_writable(wsi);
+        break;
+    }
+
+    case /*  4 */ LWS_CALLBACK_CLOSED: {
+        auto session = impl.sessions_.find(wsi);
+        if (session != impl.sessions_.end()) {
+            lws_sul_cancel(&session->second->timer.sul);
+            impl.sessions_.erase(session);
+        }
+        break;
+    }
+
+    case /* 11 */ LWS_CALLBACK_SERVER_WRITEABLE: {
+        auto session = impl.sessions_.find(wsi);
+        if (session != impl.sessions_.end()) {
+            return impl.write_next_(*session->second);
+        }
+        break;
+    }
+
+    default: break;
+    }
+
+    return 0;
+}
+
+void lws_replay_resume(lws_sorted_usec_list_t* sul) {
+    ReplaySession& session = *reinterpret_cast<LwsReplayTimer*>(sul)->session;
+    lws_callback_on_writable(session.wsi);
+}
+
+ReplayServer::ReplayServer(const Recording& recording) :
+    impl_(std::make_unique<ReplayServerImpl>(Recording(recording))) {}
+
+ReplayServer::ReplayServer(Recording&& recording) :
+    impl_(std::make_unique<ReplayServerImpl>(std::move(recording))) {}
+
+ReplayServer::~ReplayServer() = default;
+
+double ReplayServer::speed() const {
+    return impl_->speed();
+}
+
+ReplayServer& ReplayServer::speed(const double& speed) {
+    impl_->speed(speed);
+    return *this;
+}
+
+ReplayServer& ReplayServer::start(const std::uint16_t& port) {
+    impl_->start(port);
+    return *this;
+}
+
+ReplayServer& ReplayServer::stop() {
+    impl_->stop();
+    return *this;
+}
+
+bool ReplayServer::running() const {
+    return impl_->running();
+}
+
+std::uint64_t ReplayServer::sent() const {
+    return impl_->sent();
+}
+
+} // namespace rayalto::utils::network::websocket
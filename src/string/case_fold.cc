@@ -0,0 +1,179 @@
+#include "rautils/string/case_fold.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define RA_UTILS_CASE_FOLD_SSE2
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define RA_UTILS_CASE_FOLD_AVX2
+#endif
+
+namespace rayalto::utils::string {
+
+namespace {
+
+constexpr std::uint64_t ONES = 0x0101010101010101ULL;
+constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+std::uint64_t load_word(const char* data) {
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// lower case 8 ascii letters at once, other bytes are untouched
+std::uint64_t to_lower_word(const std::uint64_t& word) {
+    const std::uint64_t heptets = word & ~HIGH_BITS;
+    // high bit of each byte set if the byte is >= 'A' / > 'Z'
+    const std::uint64_t above_a = heptets + (0x80 - 'A') * ONES;
+    const std::uint64_t above_z = heptets + (0x7F - 'Z') * ONES;
+    const std::uint64_t is_upper = (above_a ^ above_z) & ~word & HIGH_BITS;
+    return word | (is_upper >> 2);
+}
+
+#ifdef RA_UTILS_CASE_FOLD_SSE2
+__m128i to_lower_sse2(const __m128i& v) {
+    // bytes >= 0x80 are negative and never match
+    const __m128i upper =
+        _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                      _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+#ifdef RA_UTILS_CASE_FOLD_AVX2
+__attribute__((target("avx2"))) std::size_t
+mismatch_avx2(const char* lv, const char* rv, const std::size_t& length) {
+    const __m256i a_minus_1 = _mm256_set1_epi8('A' - 1);
+    const __m256i z_plus_1 = _mm256_set1_epi8('Z' + 1);
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i l =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lv + i));
+        __m256i r =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rv + i));
+        l = _mm256_or_si256(
+            l,
+            _mm256_and_si256(
+                _mm256_and_si256(_mm256_cmpgt_epi8(l, a_minus_1),
+                                 _mm256_cmpgt_epi8(z_plus_1, l)),
+                case_bit));
+        r = _mm256_or_si256(
+            r,
+            _mm256_and_si256(
+                _mm256_and_si256(_mm256_cmpgt_epi8(r, a_minus_1),
+                                 _mm256_cmpgt_epi8(z_plus_1, r)),
+                case_bit));
+        const std::uint32_t different = ~static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(l, r)));
+        if (different != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(different));
+        }
+    }
+    return i;
+}
+
+bool has_avx2() {
+    static const bool has_avx2 = []() -> bool {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }();
+    return has_avx2;
+}
+#endif
+
+// index of the first byte that differs ignoring case, `length` if none
+std::size_t mismatch_ic(const char* lv,
+                        const char* rv,
+                        const std::size_t& length) {
+    std::size_t i = 0;
+#ifdef RA_UTILS_CASE_FOLD_AVX2
+    if (length >= 32 && has_avx2()) {
+        i = mismatch_avx2(lv, rv, length);
+        if (i + 32 <= length) {
+            return i;
+        }
+    }
+#endif
+#ifdef RA_UTILS_CASE_FOLD_SSE2
+    for (; i + 16 <= length; i += 16) {
+        const __m128i l = to_lower_sse2(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(lv + i)));
+        const __m128i r = to_lower_sse2(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(rv + i)));
+        const unsigned int different =
+            ~static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(l, r)))
+            & 0xFFFFU;
+        if (different != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(different));
+        }
+    }
+#endif
+    for (; i + 8 <= length; i += 8) {
+        if (to_lower_word(load_word(lv + i))
+            != to_lower_word(load_word(rv + i))) {
+            break;
+        }
+    }
+    for (; i < length; i++) {
+        if (to_lower_ascii(lv[i]) != to_lower_ascii(rv[i])) {
+            return i;
+        }
+    }
+    return length;
+}
+
+} // namespace
+
+bool equals_ic(const std::string_view& lv, const std::string_view& rv) noexcept {
+    return lv.length() == rv.length()
+           && mismatch_ic(lv.data(), rv.data(), lv.length()) == lv.length();
+}
+
+int casecmp(const std::string_view& lv, const std::string_view& rv) noexcept {
+    const std::size_t length = std::min(lv.length(), rv.length());
+    const std::size_t i = mismatch_ic(lv.data(), rv.data(), length);
+    if (i == length) {
+        return lv.length() < rv.length() ? -1
+               : lv.length() > rv.length() ? 1
+                                           : 0;
+    }
+    return static_cast<int>(static_cast<unsigned char>(to_lower_ascii(lv[i])))
+           - static_cast<int>(static_cast<unsigned char>(to_lower_ascii(rv[i])));
+}
+
+std::size_t hash_ic(const std::string_view& str) noexcept {
+    constexpr std::uint64_t K1 = 0x9E3779B97F4A7C15ULL;
+    constexpr std::uint64_t K2 = 0xC2B2AE3D27D4EB4FULL;
+    const char* data = str.data();
+    std::size_t length = str.length();
+    std::uint64_t hash = static_cast<std::uint64_t>(length) * K1;
+    for (; length >= 8; data += 8, length -= 8) {
+        hash ^= to_lower_word(load_word(data)) * K2;
+        hash = ((hash << 31) | (hash >> 33)) * K1;
+    }
+    if (length > 0) {
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, data, length);
+        hash ^= to_lower_word(tail) * K2;
+        hash = ((hash << 31) | (hash >> 33)) * K1;
+    }
+    // murmur3 finalizer
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return static_cast<std::size_t>(hash);
+}
+
+} // namespace rayalto::utils::string
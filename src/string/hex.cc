@@ -0,0 +1,248 @@
+#include "rautils/string/hex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define RA_UTILS_HEX_X86
+#endif
+
+namespace rayalto::utils::string {
+
+namespace {
+
+constexpr char HEX_LOWER[] = "0123456789abcdef";
+constexpr char HEX_UPPER[] = "0123456789ABCDEF";
+
+// 0xf for characters that are not hex digits, same as parse_hex always did
+constexpr std::array<unsigned char, 256> NIBBLES = []() {
+    std::array<unsigned char, 256> nibbles {};
+    for (std::size_t c = 0; c < nibbles.size(); c++) {
+        nibbles[c] = 0x0f;
+    }
+    for (unsigned char c = 0; c < 10; c++) {
+        nibbles['0' + c] = c;
+    }
+    for (unsigned char c = 0; c < 6; c++) {
+        nibbles['a' + c] = static_cast<unsigned char>(10 + c);
+        nibbles['A' + c] = static_cast<unsigned char>(10 + c);
+    }
+    return nibbles;
+}();
+
+void encode_scalar(const unsigned char* data,
+                   const std::size_t& length,
+                   char* out,
+                   const char* digits) {
+    for (std::size_t i = 0; i < length; i++) {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0x0f];
+    }
+}
+
+void decode_scalar(const char* hex,
+                   const std::size_t& pairs,
+                   unsigned char* out) {
+    for (std::size_t i = 0; i < pairs; i++) {
+        out[i] = static_cast<unsigned char>(
+            (NIBBLES[static_cast<unsigned char>(hex[2 * i])] << 4)
+            | NIBBLES[static_cast<unsigned char>(hex[2 * i + 1])]);
+    }
+}
+
+#ifdef RA_UTILS_HEX_X86
+bool has_ssse3() {
+    static const bool has_ssse3 = []() -> bool {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3");
+    }();
+    return has_ssse3;
+}
+
+bool has_avx2() {
+    static const bool has_avx2 = []() -> bool {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }();
+    return has_avx2;
+}
+
+// bytes done, 16 at a time
+__attribute__((target("ssse3"))) std::size_t
+encode_ssse3(const unsigned char* data,
+             const std::size_t& length,
+             char* out,
+             const char* digits) {
+    const __m128i lut =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+    const __m128i low_mask = _mm_set1_epi8(0x0f);
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        const __m128i bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i high = _mm_shuffle_epi8(
+            lut, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+        const __m128i low =
+            _mm_shuffle_epi8(lut, _mm_and_si128(bytes, low_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+                         _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16),
+                         _mm_unpackhi_epi8(high, low));
+    }
+    return i;
+}
+
+// bytes done, 32 at a time
+__attribute__((target("avx2"))) std::size_t
+encode_avx2(const unsigned char* data,
+            const std::size_t& length,
+            char* out,
+            const char* digits) {
+    const __m256i lut = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)));
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        const __m256i bytes =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i high = _mm256_shuffle_epi8(
+            lut, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_mask));
+        const __m256i low =
+            _mm256_shuffle_epi8(lut, _mm256_and_si256(bytes, low_mask));
+        // unpack works per 128-bit lane, put the lanes back in order
+        const __m256i first = _mm256_unpacklo_epi8(high, low);
+        const __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i),
+                            _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32),
+                            _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+// 16 characters to nibbles, 0xf for non hex digits
+__attribute__((target("ssse3"))) __m128i nibbles_ssse3(const __m128i& chars) {
+    const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(
+        _mm_subs_epu8(digit, _mm_set1_epi8(9)), _mm_setzero_si128());
+    const __m128i letter = _mm_sub_epi8(
+        _mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_letter = _mm_cmpeq_epi8(
+        _mm_subs_epu8(letter, _mm_set1_epi8(5)), _mm_setzero_si128());
+    const __m128i invalid = _mm_andnot_si128(_mm_or_si128(is_digit, is_letter),
+                                             _mm_set1_epi8(0x0f));
+    return _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(is_digit, digit),
+                     _mm_and_si128(is_letter,
+                                   _mm_add_epi8(letter, _mm_set1_epi8(10)))),
+        invalid);
+}
+
+// pairs done, 16 at a time
+__attribute__((target("ssse3"))) std::size_t
+decode_ssse3(const char* hex, const std::size_t& pairs, unsigned char* out) {
+    // high nibble * 16 + low nibble for every pair of bytes
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    std::size_t i = 0;
+    for (; i + 16 <= pairs; i += 16) {
+        const __m128i first = _mm_maddubs_epi16(
+            nibbles_ssse3(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i))),
+            weights);
+        const __m128i second = _mm_maddubs_epi16(
+            nibbles_ssse3(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(hex + 2 * i + 16))),
+            weights);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_packus_epi16(first, second));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) __m256i nibbles_avx2(const __m256i& chars) {
+    const __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(
+        _mm256_subs_epu8(digit, _mm256_set1_epi8(9)), _mm256_setzero_si256());
+    const __m256i letter = _mm256_sub_epi8(
+        _mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i is_letter = _mm256_cmpeq_epi8(
+        _mm256_subs_epu8(letter, _mm256_set1_epi8(5)), _mm256_setzero_si256());
+    const __m256i invalid = _mm256_andnot_si256(
+        _mm256_or_si256(is_digit, is_letter), _mm256_set1_epi8(0x0f));
+    return _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_and_si256(is_digit, digit),
+            _mm256_and_si256(is_letter,
+                             _mm256_add_epi8(letter, _mm256_set1_epi8(10)))),
+        invalid);
+}
+
+// pairs done, 32 at a time
+__attribute__((target("avx2"))) std::size_t
+decode_avx2(const char* hex, const std::size_t& pairs, unsigned char* out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    std::size_t i = 0;
+    for (; i + 32 <= pairs; i += 32) {
+        const __m256i first = _mm256_maddubs_epi16(
+            nibbles_avx2(_mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(hex + 2 * i))),
+            weights);
+        const __m256i second = _mm256_maddubs_epi16(
+            nibbles_avx2(_mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(hex + 2 * i + 32))),
+            weights);
+        // pack works per 128-bit lane, put the lanes back in order
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + i),
+            _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second),
+                                     _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    return i;
+}
+#endif
+
+} // namespace
+
+void hex_encode(const unsigned char* data,
+                const std::size_t& length,
+                char* out,
+                const bool& upper_case) noexcept {
+    const char* digits = upper_case ? HEX_UPPER : HEX_LOWER;
+    std::size_t done = 0;
+#ifdef RA_UTILS_HEX_X86
+    if (length >= 32 && has_avx2()) {
+        done = encode_avx2(data, length, out, digits);
+    }
+    if (length - done >= 16 && has_ssse3()) {
+        done += encode_ssse3(
+            data + done, length - done, out + 2 * done, digits);
+    }
+#endif
+    encode_scalar(data + done, length - done, out + 2 * done, digits);
+}
+
+std::size_t hex_decode(const char* hex,
+                       const std::size_t& length,
+                       unsigned char* out) noexcept {
+    const std::size_t pairs = length / 2;
+    std::size_t done = 0;
+#ifdef RA_UTILS_HEX_X86
+    if (pairs >= 32 && has_avx2()) {
+        done = decode_avx2(hex, pairs, out);
+    }
+    if (pairs - done >= 16 && has_ssse3()) {
+        done += decode_ssse3(hex + 2 * done, pairs - done, out + done);
+    }
+#endif
+    decode_scalar(hex + 2 * done, pairs - done, out + done);
+    if (length % 2 == 1) {
+        out[pairs] = static_cast<unsigned char>(
+            NIBBLES[static_cast<unsigned char>(hex[length - 1])] << 4);
+        return pairs + 1;
+    }
+    return pairs;
+}
+
+} // namespace rayalto::utils::string
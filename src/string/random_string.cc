@@ -0,0 +1,150 @@
+#include "rautils/string/random_string.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "openssl/rand.h"
+
+#include "rautils/exceptions/exceptions.h"
+
+namespace rayalto::utils::string {
+
+namespace {
+
+std::uint64_t rotl(const std::uint64_t& x, const int& k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256**, https://prng.di.unimi.it
+std::uint64_t next(std::uint64_t (&state)[4]) {
+    const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+    const std::uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+}
+
+// splitmix64, to spread a single seed over the whole state
+std::uint64_t split_mix(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+RandomString::RandomString(const std::string_view& alphabet,
+                           const Source& source) :
+    alphabet_(alphabet), source_(source) {
+    init_();
+    if (source_ == Source::FAST) {
+        std::random_device random_device;
+        for (std::uint64_t& word : state_) {
+            word = (static_cast<std::uint64_t>(random_device()) << 32)
+                   | random_device();
+        }
+        // all zero is the one state xoshiro can not leave
+        if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0) {
+            state_[0] = 1;
+        }
+    }
+}
+
+RandomString::RandomString(const std::string_view& alphabet,
+                           const std::uint64_t& seed) :
+    alphabet_(alphabet), source_(Source::FAST) {
+    init_();
+    std::uint64_t x = seed;
+    for (std::uint64_t& word : state_) {
+        word = split_mix(x);
+    }
+}
+
+std::string RandomString::operator()(const std::size_t& length) {
+    std::string result(length, '\0');
+    fill(result.data(), length);
+    return result;
+}
+
+void RandomString::fill(char* out, const std::size_t& length) {
+    std::size_t written = 0;
+    while (written < length) {
+        if (position_ == BUFFER_SIZE) {
+            refill_();
+        }
+        const unsigned char* bytes = buffer_.data() + position_;
+        // every value is written, but only accepted ones move on
+        if (!wide_) {
+            const std::size_t take =
+                std::min(BUFFER_SIZE - position_, length - written);
+            for (std::size_t i = 0; i < take; i++) {
+                out[written] = table_[bytes[i]];
+                written += bytes[i] < limit_ ? 1 : 0;
+            }
+            position_ += take;
+            continue;
+        }
+        const std::size_t take =
+            std::min((BUFFER_SIZE - position_) / 2, length - written);
+        for (std::size_t i = 0; i < take; i++) {
+            const std::uint32_t value =
+                bytes[2 * i]
+                | (static_cast<std::uint32_t>(bytes[2 * i + 1]) << 8);
+            out[written] = alphabet_[value % alphabet_.length()];
+            written += value < limit_ ? 1 : 0;
+        }
+        position_ += 2 * take;
+    }
+}
+
+const std::string& RandomString::alphabet() const noexcept {
+    return alphabet_;
+}
+
+const RandomString::Source& RandomString::source() const noexcept {
+    return source_;
+}
+
+void RandomString::init_() {
+    if (alphabet_.empty() || alphabet_.length() > 65536) {
+        throw exceptions::Exception(
+            "InvalidArgument",
+            "RandomString::RandomString()",
+            "Alphabet of " + std::to_string(alphabet_.length())
+                + " characters, expected 1 to 65536");
+    }
+    wide_ = alphabet_.length() > 256;
+    const std::uint32_t range = wide_ ? 65536 : 256;
+    limit_ = range
+             - range % static_cast<std::uint32_t>(alphabet_.length());
+    for (std::size_t byte = 0; byte < table_.size(); byte++) {
+        table_[byte] = alphabet_[byte % alphabet_.length()];
+    }
+}
+
+void RandomString::refill_() {
+    if (source_ == Source::SECURE) {
+        if (RAND_bytes(buffer_.data(), static_cast<int>(BUFFER_SIZE)) <= 0) {
+            throw exceptions::OpensslError("RAND_bytes()");
+        }
+    }
+    else {
+        for (std::size_t i = 0; i < BUFFER_SIZE; i += 8) {
+            const std::uint64_t word = next(state_);
+            std::memcpy(buffer_.data() + i, &word, sizeof(word));
+        }
+    }
+    position_ = 0;
+}
+
+} // namespace rayalto::utils::string
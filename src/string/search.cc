@@ -0,0 +1,468 @@
+#include "rautils/string/search.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "rautils/string/case_fold.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define RA_UTILS_SEARCH_SSE2
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define RA_UTILS_SEARCH_AVX2
+#endif
+
+namespace rayalto::utils::string {
+
+namespace {
+
+constexpr std::size_t NPOS = std::string_view::npos;
+
+// whether the candidate filter has verified so many false candidates over
+// `scanned` bytes that Two-Way would be cheaper
+bool over_budget(const std::size_t& verified, const std::size_t& scanned) {
+    return verified > 64 + scanned / 4;
+}
+
+// start of the right half of a critical factorization of `needle`, `period`
+// is set to the period of the needle if it is periodic. Crochemore-Perrin:
+// the longer of the maximal suffixes under both byte orders
+std::size_t critical_factorization(const std::string_view& needle,
+                                   std::size_t& period) {
+    std::size_t suffixes[2];
+    std::size_t periods[2];
+    for (int reversed = 0; reversed < 2; reversed++) {
+        // SIZE_MAX + k wraps around to k - 1
+        std::size_t suffix = SIZE_MAX;
+        std::size_t j = 0;
+        std::size_t k = 1;
+        std::size_t p = 1;
+        while (j + k < needle.length()) {
+            const unsigned char a = static_cast<unsigned char>(needle[j + k]);
+            const unsigned char b =
+                static_cast<unsigned char>(needle[suffix + k]);
+            if (reversed ? a > b : a < b) {
+                j += k;
+                k = 1;
+                p = j - suffix;
+            }
+            else if (a == b) {
+                if (k != p) {
+                    k += 1;
+                }
+                else {
+                    j += p;
+                    k = 1;
+                }
+            }
+            else {
+                suffix = j++;
+                k = p = 1;
+            }
+        }
+        suffixes[reversed] = suffix + 1;
+        periods[reversed] = p;
+    }
+    const int longer = suffixes[1] < suffixes[0] ? 0 : 1;
+    period = periods[longer];
+    return suffixes[longer];
+}
+
+// Two-Way string matching, linear in the haystack length and allocation free
+std::size_t find_two_way(const std::string_view& haystack,
+                         const std::string_view& needle,
+                         std::size_t j) {
+    const std::size_t m = needle.length();
+    const std::size_t last = haystack.length() - m;
+    std::size_t period = 0;
+    const std::size_t suffix = critical_factorization(needle, period);
+    if (std::memcmp(needle.data(), needle.data() + period, suffix) == 0) {
+        // periodic needle, remember how much of the right half is known to
+        // match after shifting by the period
+        std::size_t memory = 0;
+        while (j <= last) {
+            std::size_t i = std::max(suffix, memory);
+            while (i < m && needle[i] == haystack[i + j]) {
+                i += 1;
+            }
+            if (i < m) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+            i = suffix - 1;
+            while (memory < i + 1 && needle[i] == haystack[i + j]) {
+                i -= 1;
+            }
+            if (i + 1 < memory + 1) {
+                return j;
+            }
+            j += period;
+            memory = m - period;
+        }
+        return NPOS;
+    }
+    // the halves differ, every mismatch in the left half shifts the most
+    period = std::max(suffix, m - suffix) + 1;
+    while (j <= last) {
+        std::size_t i = suffix;
+        while (i < m && needle[i] == haystack[i + j]) {
+            i += 1;
+        }
+        if (i < m) {
+            j += i - suffix + 1;
+            continue;
+        }
+        i = suffix - 1;
+        while (i != SIZE_MAX && needle[i] == haystack[i + j]) {
+            i -= 1;
+        }
+        if (i == SIZE_MAX) {
+            return j;
+        }
+        j += period;
+    }
+    return NPOS;
+}
+
+// whether `needle` (length >= 2) starts at one of `candidates`, which are
+// bits over haystack + i
+std::size_t verify(const char* haystack,
+                   const std::size_t& i,
+                   std::uint32_t candidates,
+                   const std::string_view& needle,
+                   std::size_t& verified) {
+    while (candidates != 0) {
+        const std::size_t index =
+            i + static_cast<std::size_t>(__builtin_ctz(candidates));
+        if (std::memcmp(haystack + index + 1,
+                        needle.data() + 1,
+                        needle.length() - 2)
+            == 0) {
+            return index;
+        }
+        verified += 1;
+        candidates &= candidates - 1;
+    }
+    return NPOS;
+}
+
+// first byte through memchr, then last byte, then the rest. Stops with `i`
+// at the next candidate when over budget
+std::size_t find_scalar(const std::string_view& haystack,
+                        const std::string_view& needle,
+                        std::size_t& i,
+                        std::size_t& verified,
+                        const std::size_t& pos) {
+    const std::size_t last = haystack.length() - needle.length();
+    while (i <= last) {
+        const void* found =
+            std::memchr(haystack.data() + i, needle.front(), last - i + 1);
+        if (found == nullptr) {
+            return NPOS;
+        }
+        i = static_cast<std::size_t>(static_cast<const char*>(found)
+                                     - haystack.data());
+        if (over_budget(verified, i - pos)) {
+            return NPOS;
+        }
+        if (haystack[i + needle.length() - 1] == needle.back()
+            && std::memcmp(haystack.data() + i + 1,
+                           needle.data() + 1,
+                           needle.length() - 2)
+                   == 0) {
+            return i;
+        }
+        verified += 1;
+        i += 1;
+    }
+    return NPOS;
+}
+
+#ifdef RA_UTILS_SEARCH_SSE2
+// candidates checked 16 at a time, `i` is moved past the blocks done
+std::size_t find_sse2(const std::string_view& haystack,
+                      const std::string_view& needle,
+                      std::size_t& i,
+                      std::size_t& verified,
+                      const std::size_t& pos) {
+    const __m128i first = _mm_set1_epi8(needle.front());
+    const __m128i last = _mm_set1_epi8(needle.back());
+    const char* data = haystack.data();
+    for (; i + needle.length() - 1 + 16 <= haystack.length(); i += 16) {
+        if (over_budget(verified, i - pos)) {
+            return NPOS;
+        }
+        const __m128i block_first =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i block_last = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data + i + needle.length() - 1));
+        const std::uint32_t candidates =
+            static_cast<std::uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                              _mm_cmpeq_epi8(last, block_last))));
+        const std::size_t found = verify(data, i, candidates, needle, verified);
+        if (found != NPOS) {
+            return found;
+        }
+    }
+    return NPOS;
+}
+#endif
+
+#ifdef RA_UTILS_SEARCH_AVX2
+bool has_avx2() {
+    static const bool has_avx2 = []() -> bool {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }();
+    return has_avx2;
+}
+
+// candidates checked 32 at a time, `i` is moved past the blocks done
+__attribute__((target("avx2"))) std::size_t
+find_avx2(const std::string_view& haystack,
+          const std::string_view& needle,
+          std::size_t& i,
+          std::size_t& verified,
+          const std::size_t& pos) {
+    const __m256i first = _mm256_set1_epi8(needle.front());
+    const __m256i last = _mm256_set1_epi8(needle.back());
+    const char* data = haystack.data();
+    for (; i + needle.length() - 1 + 32 <= haystack.length(); i += 32) {
+        if (over_budget(verified, i - pos)) {
+            return NPOS;
+        }
+        const __m256i block_first =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i block_last = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(data + i + needle.length() - 1));
+        const std::uint32_t candidates =
+            static_cast<std::uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+                                 _mm256_cmpeq_epi8(last, block_last))));
+        const std::size_t found = verify(data, i, candidates, needle, verified);
+        if (found != NPOS) {
+            return found;
+        }
+    }
+    return NPOS;
+}
+#endif
+
+} // namespace
+
+std::size_t find_first(const std::string_view& haystack,
+                       const std::string_view& needle,
+                       const std::size_t& pos) noexcept {
+    if (pos > haystack.length()
+        || needle.length() > haystack.length() - pos) {
+        return NPOS;
+    }
+    if (needle.empty()) {
+        return pos;
+    }
+    if (needle.length() == 1) {
+        const void* found = std::memchr(
+            haystack.data() + pos, needle.front(), haystack.length() - pos);
+        return found == nullptr
+                   ? NPOS
+                   : static_cast<std::size_t>(static_cast<const char*>(found)
+                                              - haystack.data());
+    }
+    std::size_t i = pos;
+    std::size_t verified = 0;
+    std::size_t found = NPOS;
+#ifdef RA_UTILS_SEARCH_AVX2
+    if (has_avx2()) {
+        found = find_avx2(haystack, needle, i, verified, pos);
+    }
+#endif
+#ifdef RA_UTILS_SEARCH_SSE2
+    if (found == NPOS && !over_budget(verified, i - pos)) {
+        found = find_sse2(haystack, needle, i, verified, pos);
+    }
+#endif
+    if (found == NPOS && !over_budget(verified, i - pos)) {
+        found = find_scalar(haystack, needle, i, verified, pos);
+    }
+    if (found == NPOS && over_budget(verified, i - pos)) {
+        found = find_two_way(haystack, needle, i);
+    }
+    return found;
+}
+
+AhoCorasick::AhoCorasick(std::initializer_list<std::string_view> patterns,
+                         const bool& case_insensitive) {
+    build_(patterns, case_insensitive);
+}
+
+AhoCorasick::AhoCorasick(const std::vector<std::string>& patterns,
+                         const bool& case_insensitive) {
+    build_({patterns.begin(), patterns.end()}, case_insensitive);
+}
+
+std::size_t AhoCorasick::size() const noexcept {
+    return lengths_.size();
+}
+
+std::optional<AhoCorasick::Match> AhoCorasick::find(
+    const std::string_view& text) const noexcept {
+    State row = 0;
+    for (std::size_t i = 0; i < text.length(); i++) {
+        row = step_(row, text[i]);
+        if (row < match_row_) {
+            continue;
+        }
+        State matched = row / static_cast<State>(classes_);
+        if (output_[matched] == NONE) {
+            matched = output_link_[matched];
+        }
+        // the longest pattern ending here starts first
+        const std::uint32_t pattern = output_[matched];
+        return Match {pattern, i + 1 - lengths_[pattern]};
+    }
+    return std::nullopt;
+}
+
+bool AhoCorasick::contains(const std::string_view& text) const noexcept {
+    return find(text).has_value();
+}
+
+std::vector<AhoCorasick::Match> AhoCorasick::find_all(
+    const std::string_view& text) const {
+    std::vector<Match> matches;
+    for_each(text, [&matches](const Match& match) {
+        matches.push_back(match);
+    });
+    return matches;
+}
+
+void AhoCorasick::build_(const std::vector<std::string_view>& patterns,
+                         const bool& case_insensitive) {
+    auto fold = [&case_insensitive](const char& c) -> unsigned char {
+        return static_cast<unsigned char>(case_insensitive ? to_lower_ascii(c)
+                                                           : c);
+    };
+    // number the bytes that appear in patterns, 0 is everything else
+    for (const std::string_view& pattern : patterns) {
+        for (const char& c : pattern) {
+            std::uint16_t& byte_class = class_of_[fold(c)];
+            if (byte_class == 0) {
+                byte_class = static_cast<std::uint16_t>(classes_++);
+            }
+        }
+    }
+    if (case_insensitive) {
+        for (char c = 'A'; c <= 'Z'; c++) {
+            class_of_[static_cast<unsigned char>(c)] =
+                class_of_[static_cast<unsigned char>(to_lower_ascii(c))];
+        }
+    }
+
+    // trie, 0 in next_ means no edge yet
+    next_.assign(classes_, 0);
+    output_.assign(1, NONE);
+    lengths_.reserve(patterns.size());
+    same_output_.assign(patterns.size(), NONE);
+    for (std::size_t index = 0; index < patterns.size(); index++) {
+        const std::string_view& pattern = patterns[index];
+        lengths_.push_back(pattern.length());
+        if (pattern.empty()) {
+            continue;
+        }
+        State state = 0;
+        for (const char& c : pattern) {
+            const std::size_t edge = state * classes_ + class_of_[fold(c)];
+            if (next_[edge] == 0) {
+                next_[edge] = static_cast<State>(output_.size());
+                next_.resize(next_.size() + classes_, 0);
+                output_.push_back(NONE);
+            }
+            state = next_[edge];
+        }
+        // keep the patterns ending here in order
+        std::uint32_t* tail = &output_[state];
+        while (*tail != NONE) {
+            tail = &same_output_[*tail];
+        }
+        *tail = static_cast<std::uint32_t>(index);
+    }
+
+    // breadth first, so the failure state of every state is complete before
+    // its row is filled in
+    std::vector<State> failure(output_.size(), 0);
+    output_link_.assign(output_.size(), 0);
+    std::queue<State> queue;
+    for (std::size_t byte_class = 0; byte_class < classes_; byte_class++) {
+        if (next_[byte_class] != 0) {
+            queue.push(next_[byte_class]);
+        }
+    }
+    while (!queue.empty()) {
+        const State state = queue.front();
+        queue.pop();
+        const State fallback = failure[state];
+        for (std::size_t byte_class = 0; byte_class < classes_; byte_class++) {
+            State& target = next_[state * classes_ + byte_class];
+            const State fallback_target =
+                next_[fallback * classes_ + byte_class];
+            if (target == 0) {
+                target = fallback_target;
+                continue;
+            }
+            failure[target] = fallback_target;
+            output_link_[target] = output_[fallback_target] != NONE
+                                       ? fallback_target
+                                       : output_link_[fallback_target];
+            queue.push(target);
+        }
+    }
+
+    // renumber the states so those with an output come last, then store the
+    // target rows instead of the target states
+    const std::size_t states = output_.size();
+    std::vector<State> renumbered(states, 0);
+    State count = 0;
+    for (int matching = 0; matching < 2; matching++) {
+        for (std::size_t state = 0; state < states; state++) {
+            const bool has_output =
+                output_[state] != NONE || output_link_[state] != 0;
+            if (has_output == (matching == 1)) {
+                renumbered[state] = count++;
+            }
+        }
+        if (matching == 0) {
+            match_row_ = static_cast<State>(count * classes_);
+        }
+    }
+    std::vector<State> next(next_.size());
+    std::vector<std::uint32_t> output(states);
+    std::vector<State> output_link(states);
+    for (std::size_t state = 0; state < states; state++) {
+        const State to = renumbered[state];
+        for (std::size_t byte_class = 0; byte_class < classes_; byte_class++) {
+            next[to * classes_ + byte_class] = static_cast<State>(
+                renumbered[next_[state * classes_ + byte_class]] * classes_);
+        }
+        output[to] = output_[state];
+        output_link[to] = renumbered[output_link_[state]];
+    }
+    next_ = std::move(next);
+    output_ = std::move(output);
+    output_link_ = std::move(output_link);
+}
+
+} // namespace rayalto::utils::string
@@ -1,56 +1,53 @@
 #include "rautils/string/strtool.h"
 
-#include <algorithm>
-#include <cctype>
 #include <cstddef>
 #include <cstring>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
-#include <numeric>
-#include <random>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "rautils/string/case_fold.h"
+#include "rautils/string/char_set.h"
+#include "rautils/string/hex.h"
+#include "rautils/string/random_string.h"
+#include "rautils/string/search.h"
+
 namespace rayalto::utils::string {
 
-unsigned char hex2bin(const char& c) {
-    if (c >= '0' && c <= '9') {
-        return c - '0';
-    }
-    if (c >= 'A' && c <= 'F') {
-        return c - 'A' + 10;
-    }
-    if (c >= 'a' && c <= 'f') {
-        return c - 'a' + 10;
+namespace {
+
+CharSet to_char_set(const std::unordered_set<char>& chars) {
+    CharSet set;
+    for (const char& c : chars) {
+        set.insert(c);
     }
-    return -1;
+    return set;
 }
 
+// an empty set strips space characters, as it always did
+CharSet strip_set(const std::unordered_set<char>& chars) {
+    return chars.empty() ? SPACES : to_char_set(chars);
+}
+
+} // namespace
+
 std::string lstrip(std::string&& str) {
     return lstrip(str);
 }
 
 std::string lstrip(std::string& str) {
-    str.erase(
-        str.begin(),
-        std::find_if(str.begin(), str.end(), [](unsigned char ch) -> bool {
-            return std::isspace(ch) == 0;
-        }));
+    str.erase(0, str.length() - lstrip_view(str).length());
     return str;
 }
 
 std::string lstrip(const std::string& str) {
-    std::string result(str);
-    result.erase(
-        result.begin(),
-        std::find_if(
-            result.begin(), result.end(), [](unsigned char ch) -> bool {
-                return std::isspace(ch) == 0;
-            }));
-    return result;
+    return std::string(lstrip_view(str));
 }
 
 std::string rstrip(std::string&& str) {
@@ -58,24 +55,12 @@ std::string rstrip(std::string&& str) {
 }
 
 std::string rstrip(std::string& str) {
-    str.erase(
-        std::find_if(str.rbegin(),
-                     str.rend(),
-                     [](unsigned char ch) { return std::isspace(ch) == 0; })
-            .base(),
-        str.end());
+    str.resize(rstrip_view(str).length());
     return str;
 }
 
 std::string rstrip(const std::string& str) {
-    std::string result(str);
-    result.erase(
-        std::find_if(result.rbegin(),
-                     result.rend(),
-                     [](unsigned char ch) { return std::isspace(ch) == 0; })
-            .base(),
-        result.end());
-    return result;
+    return std::string(rstrip_view(str));
 }
 
 std::string strip(std::string&& str) {
@@ -88,10 +73,7 @@ std::string strip(std::string& str) {
 }
 
 std::string strip(const std::string& str) {
-    std::string result(str);
-    lstrip(result);
-    rstrip(result);
-    return result;
+    return std::string(strip_view(str));
 }
 
 std::string lstrip(std::string&& str, const std::unordered_set<char>& chars) {
@@ -99,30 +81,13 @@ std::string lstrip(std::string&& str, const std::unordered_set<char>& chars) {
 }
 
 std::string lstrip(std::string& str, const std::unordered_set<char>& chars) {
-    if (chars.empty()) {
-        return lstrip(str);
-    }
-    str.erase(str.begin(),
-              std::find_if(
-                  str.begin(), str.end(), [&chars](unsigned char ch) -> bool {
-                      return (chars.count(static_cast<char>(ch)) == 0);
-                  }));
+    str.erase(0, str.length() - lstrip_view(str, strip_set(chars)).length());
     return str;
 }
 
 std::string lstrip(const std::string& str,
                    const std::unordered_set<char>& chars) {
-    std::string result(str);
-    if (chars.empty()) {
-        return lstrip(result);
-    }
-    result.erase(
-        result.begin(),
-        std::find_if(
-            result.begin(), result.end(), [&chars](unsigned char ch) -> bool {
-                return (chars.count(static_cast<char>(ch)) == 0);
-            }));
-    return result;
+    return std::string(lstrip_view(str, strip_set(chars)));
 }
 
 std::string rstrip(std::string&& str, const std::unordered_set<char>& chars) {
@@ -130,34 +95,13 @@ std::string rstrip(std::string&& str, const std::unordered_set<char>& chars) {
 }
 
 std::string rstrip(std::string& str, const std::unordered_set<char>& chars) {
-    if (chars.empty()) {
-        return rstrip(str);
-    }
-    str.erase(std::find_if(str.rbegin(),
-                           str.rend(),
-                           [&chars](unsigned char ch) {
-                               return (chars.count(static_cast<char>(ch)) == 0);
-                           })
-                  .base(),
-              str.end());
+    str.resize(rstrip_view(str, strip_set(chars)).length());
     return str;
 }
 
 std::string rstrip(const std::string& str,
                    const std::unordered_set<char>& chars) {
-    std::string result(str);
-    if (chars.empty()) {
-        return rstrip(result);
-    }
-    result.erase(
-        std::find_if(result.rbegin(),
-                     result.rend(),
-                     [&chars](unsigned char ch) {
-                         return (chars.count(static_cast<char>(ch)) == 0);
-                     })
-            .base(),
-        result.end());
-    return result;
+    return std::string(rstrip_view(str, strip_set(chars)));
 }
 
 std::string strip(std::string&& str, const std::unordered_set<char>& chars) {
@@ -165,23 +109,30 @@ std::string strip(std::string&& str, const std::unordered_set<char>& chars) {
 }
 
 std::string strip(std::string& str, const std::unordered_set<char>& chars) {
-    lstrip(str, chars);
-    return rstrip(str, chars);
+    const CharSet set = strip_set(chars);
+    const std::string_view stripped = strip_view(str, set);
+    str.erase(static_cast<std::size_t>(stripped.data() - str.data())
+                  + stripped.length());
+    str.erase(0, static_cast<std::size_t>(stripped.data() - str.data()));
+    return str;
 }
 
 std::string strip(const std::string& str,
                   const std::unordered_set<char>& chars) {
-    std::string result(str);
-    lstrip(result, chars);
-    rstrip(result, chars);
-    return result;
+    return std::string(strip_view(str, strip_set(chars)));
 }
 
 std::vector<std::string> split(const std::string& str, const char& sep) {
-    std::istringstream str_stream(str);
-    std::string line;
     std::vector<std::string> lines;
-    while (std::getline(str_stream, line, sep)) {
+    if (str.empty()) {
+        return lines;
+    }
+    // like std::getline, a trailing separator does not start another line
+    std::string_view view(str);
+    if (view.back() == sep) {
+        view.remove_suffix(1);
+    }
+    for (const std::string_view& line : split_view(view, sep)) {
         lines.emplace_back(line);
     }
     return lines;
@@ -285,94 +236,119 @@ std::pair<std::string, std::string> split_once(const std::string& str,
                           str.substr(sep_index + sep.size()));
 }
 
-std::string kv_format(const std::map<std::string, std::string>& kvs,
-                      const char& kv_delimiter,
-                      const bool& kv_space,
-                      const char& item_delimiter,
-                      const bool& item_sapce,
-                      const bool& item_delimiter_end) {
-    std::size_t kv_count = kvs.size();
-    std::size_t kv_index_end = kv_count - 1;
-    std::size_t kv_index = 0;
-    std::map<std::string, std::string>::const_iterator kv = kvs.begin();
-    std::string result;
-    result.reserve(kv_count * 8);
-    while (kv != kvs.end()) {
-        result.append(kv->first);
-        result.push_back(kv_delimiter);
-        if (kv_space) {
-            result.push_back(' ');
-        }
-        result.append(kv->second);
-        if (item_delimiter_end || (kv_index != kv_index_end)) {
-            result.push_back(item_delimiter);
-            if (item_sapce) {
-                result.push_back(' ');
-            }
-        }
-        kv++;
-        kv_index++;
+std::string_view lstrip_view(std::string_view str) {
+    return lstrip_view(str, SPACES);
+}
+
+std::string_view rstrip_view(std::string_view str) {
+    return rstrip_view(str, SPACES);
+}
+
+std::string_view strip_view(std::string_view str) {
+    return strip_view(str, SPACES);
+}
+
+std::string_view lstrip_view(std::string_view str,
+                             const std::string_view& chars) {
+    return lstrip_view(str, CharSet(chars));
+}
+
+std::string_view rstrip_view(std::string_view str,
+                             const std::string_view& chars) {
+    return rstrip_view(str, CharSet(chars));
+}
+
+std::string_view strip_view(std::string_view str,
+                            const std::string_view& chars) {
+    return strip_view(str, CharSet(chars));
+}
+
+std::string_view lstrip_view(std::string_view str, const CharSet& chars) {
+    std::size_t start = 0;
+    while (start < str.length() && chars.contains(str[start])) {
+        start += 1;
     }
-    return result;
+    return str.substr(start);
+}
+
+std::string_view rstrip_view(std::string_view str, const CharSet& chars) {
+    std::size_t end = str.length();
+    while (end > 0 && chars.contains(str[end - 1])) {
+        end -= 1;
+    }
+    return str.substr(0, end);
+}
+
+std::string_view strip_view(std::string_view str, const CharSet& chars) {
+    return rstrip_view(lstrip_view(str, chars), chars);
+}
+
+std::pair<std::string_view, std::string_view> split_once_view(
+    const std::string_view& str,
+    const char& sep) {
+    const std::size_t sep_index = str.find(sep);
+    if (sep_index == std::string_view::npos) {
+        return {str, str.substr(str.length())};
+    }
+    return {str.substr(0, sep_index), str.substr(sep_index + 1)};
+}
+
+std::pair<std::string_view, std::string_view> split_once_view(
+    const std::string_view& str,
+    const std::string_view& sep) {
+    const std::size_t sep_index = str.find(sep);
+    if (sep_index == std::string_view::npos) {
+        return {str, str.substr(str.length())};
+    }
+    return {str.substr(0, sep_index), str.substr(sep_index + sep.length())};
+}
+
+SplitView<char> split_view(const std::string_view& str, const char& sep) {
+    return {str, sep};
+}
+
+SplitView<std::string_view> split_view(const std::string_view& str,
+                                       const std::string_view& sep) {
+    return {str, sep};
 }
 
-bool compare_ic(const std::string& lv, const std::string& rv) {
-    return std::equal(lv.begin(),
-                      lv.end(),
-                      rv.begin(),
-                      [](unsigned char lc, unsigned char rc) {
-                          return std::tolower(lc) == std::tolower(rc);
-                      });
+bool compare_ic(const std::string_view& lv, const std::string_view& rv) {
+    return equals_ic(lv, rv);
 }
 
-std::string join(const std::string& str,
-                 std::initializer_list<std::string> between) {
-    return std::accumulate(std::next(between.begin()),
-                           between.end(),
-                           *between.begin(),
-                           [&str](std::string l, std::string r) -> std::string {
-                               return std::move(l) + str + std::move(r);
-                           });
+std::string join(const std::string_view& separator,
+                 std::initializer_list<std::string_view> items) {
+    return join(separator, items.begin(), items.end());
 }
 
-std::size_t count(const std::string& str, const std::string& substr) {
-    std::size_t substr_length = substr.length();
-    std::size_t index = 0;
+std::size_t count(const std::string_view& str,
+                  const std::string_view& substr) {
+    if (substr.empty()) {
+        return 0;
+    }
     std::size_t num = 0;
-    index = str.find(substr);
-    while (index != std::string::npos) {
-        ++num;
-        index = str.find(substr, index + substr_length);
+    for (std::size_t index = find_first(str, substr);
+         index != std::string_view::npos;
+         index = find_first(str, substr, index + substr.length())) {
+        num += 1;
     }
     return num;
 }
 
-bool exists(const std::string& str, const std::string& substr) {
-    return (str.find_first_of(substr) == std::string::npos);
+bool exists(const std::string_view& str, const std::string_view& substr) {
+    return find_first(str, substr) != std::string_view::npos;
 }
 
 std::string random_string(const std::size_t& len) {
-    return random_string(
-        len, {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C',
-              'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
-              'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c',
-              'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
-              'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'});
+    // seeded once per thread instead of once per call
+    thread_local RandomString random;
+    return random(len);
 }
 
 std::string random_string(const std::size_t& len,
                           const std::vector<char>& characters) {
-    std::string foo(len, 0);
-    char result[len + 1];
-    std::random_device r_device;
-    std::mt19937 random_engine(r_device());
-    std::uniform_int_distribution<std::size_t> distribution(
-        0, characters.size() - 1);
-    for (int i = 0; i < len; ++i) {
-        result[i] = characters[distribution(random_engine)];
-    }
-    result[len] = '\0';
-    return result;
+    return RandomString(
+        std::string_view(characters.data(), characters.size()))(len);
 }
 
 std::string hex_string(const std::vector<unsigned char>& data,
@@ -421,18 +397,9 @@ std::string hex_string(const unsigned char* data, const bool& upper_case) {
 std::string hex_string(const unsigned char* data,
                        const std::size_t& data_length,
                        const bool& upper_case) {
-    char result[data_length * 2 + 1];
-    result[data_length * 2] = '\0';
-    char hex_map_lower[] {"0123456789abcdef"};
-    char hex_map_upper[] {"0123456789ABCDEF"};
-    char* hex_str = upper_case ? hex_map_upper : hex_map_lower;
-    for (std::size_t i = 0; i < data_length; ++i) {
-        // clang-format off
-        result[2 * i    ] = hex_str[(data[i] >> 4) & 0x0f];
-        result[2 * i + 1] = hex_str[ data[i]       & 0x0f];
-        // clang-format on
-    }
-    return {result};
+    std::string result(data_length * 2, '\0');
+    hex_encode(data, data_length, result.data(), upper_case);
+    return result;
 }
 
 std::string data_string(const std::vector<unsigned char>& data) {
@@ -508,20 +475,8 @@ std::vector<unsigned char> parse_hex(const char* hex) {
 
 std::vector<unsigned char> parse_hex(const char* hex,
                                      const std::size_t& hex_length) {
-    std::vector<unsigned char> result;
-    unsigned char b = 0;
-    std::size_t i = 0;
-    for (i = 0; i < hex_length - 1; i += 2) {
-        b = 0;
-        b |= ((hex2bin(hex[i]) << 4) & 0xf0);
-        b |= (hex2bin(hex[i + 1]) & 0x0f);
-        result.push_back(b);
-    }
-    if (i == hex_length - 1) {
-        b = 0;
-        b |= ((hex2bin(hex[i]) << 4) & 0xf0);
-        result.push_back(b);
-    }
+    std::vector<unsigned char> result((hex_length + 1) / 2);
+    hex_decode(hex, hex_length, result.data());
     return result;
 }
 
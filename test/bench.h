@@ -0,0 +1,49 @@
+#ifndef RA_UTILS_TEST_BENCH_H_
+#define RA_UTILS_TEST_BENCH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+// the tests only check results by default, and print their timings when run
+// with --bench
+namespace bench {
+
+// results of the timed calls end up here so they are not optimized away
+inline volatile std::size_t sink = 0;
+
+// if --bench is among the arguments
+inline bool enabled(int argc, char const* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--bench") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// seconds since `start`
+inline double
+seconds_since(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                         - start)
+        .count();
+}
+
+// nanoseconds per call of `function`, which returns something that converts
+// to std::size_t, over `rounds` calls
+template <typename Function>
+double run(const std::size_t& rounds, Function function) {
+    std::size_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < rounds; i++) {
+        checksum += static_cast<std::size_t>(function());
+    }
+    const double nanoseconds = seconds_since(start) * 1e9;
+    sink = checksum;
+    return nanoseconds / static_cast<double>(rounds);
+}
+
+} // namespace bench
+
+#endif // RA_UTILS_TEST_BENCH_H_
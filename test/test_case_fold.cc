@@ -0,0 +1,183 @@
+#include <cctype>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rautils/misc/map_handler.h"
+#include "rautils/string/case_fold.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::DictIC;
+using rayalto::utils::misc::UnorderedDictIC;
+using rayalto::utils::string::casecmp;
+using rayalto::utils::string::equals_ic;
+using rayalto::utils::string::hash_ic;
+
+constexpr std::size_t ROUNDS = 1 << 20;
+
+// the std::tolower versions this replaces
+bool locale_equals_ic(const std::string_view& lv, const std::string_view& rv) {
+    if (lv.length() != rv.length()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lv.length(); i++) {
+        if (std::tolower(static_cast<unsigned char>(lv[i]))
+            != std::tolower(static_cast<unsigned char>(rv[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t locale_hash_ic(const std::string_view& str) {
+    std::string lower(str);
+    for (char& c : lower) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return std::hash<std::string> {}(lower);
+}
+
+// std::tolower against the ascii-only versions
+void benchmark(const std::vector<std::string>& names,
+               const DictIC& ordered,
+               const UnorderedDictIC& unordered) {
+    const std::size_t sizes[] {12, 40, 256};
+    for (const std::size_t& size : sizes) {
+        std::vector<std::string> lower;
+        std::vector<std::string> upper;
+        for (int i = 0; i < 16; i++) {
+            std::string str(size, 'a');
+            for (std::size_t j = 0; j < size; j++) {
+                str[j] = static_cast<char>('a' + (i + j) % 26);
+            }
+            lower.push_back(str);
+            for (char& c : str) {
+                c = static_cast<char>(std::toupper(c));
+            }
+            upper.push_back(str);
+        }
+        std::size_t i = 0;
+        std::cout << size << " bytes:" << std::endl
+                  << "  equals  std::tolower "
+                  << bench::run(ROUNDS,
+                                [&]() {
+                                    i++;
+                                    return locale_equals_ic(lower[i % 16],
+                                                            upper[i % 16]);
+                                })
+                  << " ns, equals_ic "
+                  << bench::run(ROUNDS,
+                                [&]() {
+                                    i++;
+                                    return equals_ic(lower[i % 16],
+                                                     upper[i % 16]);
+                                })
+                  << " ns" << std::endl
+                  << "  hash    std::tolower "
+                  << bench::run(ROUNDS,
+                                [&]() {
+                                    return locale_hash_ic(upper[i++ % 16]);
+                                })
+                  << " ns, hash_ic "
+                  << bench::run(ROUNDS,
+                                [&]() { return hash_ic(upper[i++ % 16]); })
+                  << " ns" << std::endl;
+    }
+
+    std::vector<std::string> probes;
+    for (const std::string& name : names) {
+        std::string probe = name;
+        for (char& c : probe) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        probes.push_back(probe);
+    }
+    std::size_t i = 0;
+    std::cout << "header lookup: DictIC "
+              << bench::run(ROUNDS,
+                            [&]() {
+                                return ordered.find(probes[i++ % probes.size()])
+                                    ->second.size();
+                            })
+              << " ns, UnorderedDictIC "
+              << bench::run(ROUNDS,
+                            [&]() {
+                                return unordered
+                                    .find(probes[i++ % probes.size()])
+                                    ->second.size();
+                            })
+              << " ns" << std::endl;
+}
+
+int main(int argc, char const* argv[]) {
+    // check against the locale versions on random ascii
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> byte(0, 127);
+    std::uniform_int_distribution<std::size_t> length(0, 80);
+    for (int i = 0; i < 100000; i++) {
+        std::string l(length(random_engine), '\0');
+        for (char& c : l) {
+            c = static_cast<char>(byte(random_engine));
+        }
+        std::string r = l;
+        for (char& c : r) {
+            if (byte(random_engine) < 32) {
+                c = static_cast<char>(
+                    std::toupper(static_cast<unsigned char>(c)));
+            }
+        }
+        if (!r.empty() && byte(random_engine) < 16) {
+            r[r.length() / 2] = static_cast<char>(byte(random_engine));
+        }
+        const bool expected = locale_equals_ic(l, r);
+        if (equals_ic(l, r) != expected || (casecmp(l, r) == 0) != expected
+            || (expected && hash_ic(l) != hash_ic(r))) {
+            std::cerr << "mismatch: " << l << " / " << r << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<std::string> names {"Host",
+                                          "User-Agent",
+                                          "Accept",
+                                          "Accept-Language",
+                                          "Accept-Encoding",
+                                          "Connection",
+                                          "Cache-Control",
+                                          "Content-Type",
+                                          "Content-Length",
+                                          "Sec-WebSocket-Key",
+                                          "Sec-WebSocket-Version",
+                                          "Upgrade"};
+    DictIC ordered;
+    UnorderedDictIC unordered;
+    for (const std::string& name : names) {
+        ordered[name] = name;
+        unordered[name] = name;
+    }
+    // lookups must ignore case
+    for (const std::string& name : names) {
+        std::string probe = name;
+        for (char& c : probe) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        const auto ordered_it = ordered.find(probe);
+        const auto unordered_it = unordered.find(probe);
+        if (ordered_it == ordered.end() || ordered_it->second != name
+            || unordered_it == unordered.end()
+            || unordered_it->second != name) {
+            std::cerr << "lookup failed: " << probe << std::endl;
+            return 1;
+        }
+    }
+    if (bench::enabled(argc, argv)) {
+        benchmark(names, ordered, unordered);
+    }
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "rautils/string/char_set.h"
+#include "rautils/string/strtool.h"
+
+#include "bench.h"
+
+using rayalto::utils::string::CharSet;
+using rayalto::utils::string::SPACES;
+using rayalto::utils::string::strip;
+using rayalto::utils::string::strip_view;
+
+constexpr std::size_t ROUNDS = 1 << 20;
+
+static_assert(SPACES.size() == 6 && SPACES.contains('\t')
+              && !SPACES.contains('_'));
+static_assert((CharSet {"ab"} | CharSet {"bc"}) == CharSet {"abc"});
+static_assert((~CharSet {}).size() == 256);
+
+// the copy then erase version this replaces
+std::string set_strip(const std::string& str,
+                      const std::unordered_set<char>& chars) {
+    std::string result(str);
+    result.erase(result.begin(),
+                 std::find_if(result.begin(), result.end(), [&](char c) {
+                     return chars.count(c) == 0;
+                 }));
+    result.erase(std::find_if(result.rbegin(),
+                              result.rend(),
+                              [&](char c) { return chars.count(c) == 0; })
+                     .base(),
+                 result.end());
+    return result;
+}
+
+// stripping header values: the unordered_set copy, strip() and strip_view()
+void benchmark(const std::vector<std::string>& values,
+               const std::unordered_set<char>& chars,
+               const CharSet& set) {
+    std::size_t i = 0;
+    std::cout << "strip header value: unordered_set copy "
+              << bench::run(ROUNDS,
+                            [&]() {
+                                return set_strip(values[i++ % values.size()],
+                                                 chars)
+                                    .length();
+                            })
+              << " ns, strip(unordered_set) "
+              << bench::run(ROUNDS,
+                            [&]() {
+                                return strip(values[i++ % values.size()], chars)
+                                    .length();
+                            })
+              << " ns, strip_view(CharSet) "
+              << bench::run(ROUNDS,
+                            [&]() {
+                                return strip_view(values[i++ % values.size()],
+                                                  set)
+                                    .length();
+                            })
+              << " ns" << std::endl;
+}
+
+int main(int argc, char const* argv[]) {
+    // check against the unordered_set version
+    const std::unordered_set<char> chars {' ', '\t', '"', ';'};
+    const CharSet set {" \t\";"};
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<std::size_t> length(0, 12);
+    std::uniform_int_distribution<int> pick(0, 5);
+    const char alphabet[] {' ', '\t', '"', ';', 'a', '\xe4'};
+    std::vector<std::string> values;
+    for (int i = 0; i < 100000; i++) {
+        std::string str(length(random_engine), '\0');
+        for (char& c : str) {
+            c = alphabet[pick(random_engine)];
+        }
+        const std::string expected = set_strip(str, chars);
+        std::string in_place = str;
+        if (strip(str, chars) != expected || strip(in_place, chars) != expected
+            || in_place != expected || strip_view(str, set) != expected
+            || strip_view(str, " \t\";") != expected) {
+            std::cerr << "mismatch: [" << str << ']' << std::endl;
+            return 1;
+        }
+        if (values.size() < 64) {
+            values.push_back("  \"" + str + "value\"; ");
+        }
+    }
+
+    if (bench::enabled(argc, argv)) {
+        benchmark(values, chars, set);
+    }
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "rautils/misc/concurrent_map.h"
+#include "rautils/misc/map_handler.h"
+
+#include "bench.h"
+
+using namespace std::chrono_literals;
+using rayalto::utils::misc::ConcurrentMap;
+using rayalto::utils::misc::DictHandler;
+
+constexpr std::size_t KEYS = 1 << 12;
+
+// run `threads` threads doing `operations` lookups in total, one insert every
+// 16 lookups, return million operations per second
+template <typename Operation>
+double run(const std::size_t& operations,
+           const std::size_t& threads,
+           const std::vector<std::string>& keys,
+           Operation operation) {
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&operation, &keys, operations, t, threads]()
+                                 -> void {
+            const std::size_t share = operations / threads;
+            std::size_t index = t * 7919;
+            for (std::size_t i = 0; i < share; i++) {
+                index = (index + 40503) % KEYS;
+                operation(keys[index], i % 16 == 0);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return static_cast<double>(operations) / bench::seconds_since(start) / 1e6;
+}
+
+int main(int argc, char const* argv[]) {
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < KEYS; i++) {
+        keys.emplace_back("https://example.com/resource/" + std::to_string(i));
+    }
+
+    // a short stress run unless benchmarking
+    const bool benchmark = bench::enabled(argc, argv);
+    const std::size_t operations = benchmark ? 1 << 20 : 1 << 16;
+    const std::size_t max_threads = benchmark ? 16 : 4;
+    if (benchmark) {
+        std::cout << "threads\tConcurrentMap(M/s)\tDictHandler+mutex(M/s)"
+                  << std::endl;
+    }
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ConcurrentMap<std::string, std::string> concurrent_map(64);
+        const double sharded = run(
+            operations,
+            threads,
+            keys,
+            [&concurrent_map](const std::string& key, bool write) -> void {
+                if (write) {
+                    concurrent_map.insert_or_assign(key, key);
+                }
+                else {
+                    concurrent_map.get(std::string_view(key));
+                }
+            });
+        for (const std::string& key : keys) {
+            const std::optional<std::string> value =
+                concurrent_map.get(std::string_view(key));
+            if (value.has_value() && *value != key) {
+                std::cerr << "wrong value for " << key << std::endl;
+                return 1;
+            }
+        }
+        if (!benchmark) {
+            continue;
+        }
+
+        DictHandler dict;
+        std::mutex dict_mutex;
+        const double locked = run(
+            operations,
+            threads,
+            keys,
+            [&dict, &dict_mutex](const std::string& key, bool write) -> void {
+                std::lock_guard<std::mutex> lock(dict_mutex);
+                if (write) {
+                    dict[key] = key;
+                }
+                else {
+                    // copy out like ConcurrentMap::get() does
+                    auto found = dict.find(key);
+                    if (found != dict.end()) {
+                        std::string value = found->second;
+                    }
+                }
+            });
+        std::cout << threads << '\t' << sharded << "\t\t\t" << locked
+                  << std::endl;
+    }
+
+    // bounded cache: least recently used entries go first
+    ConcurrentMap<std::string, int> lru(1, 2);
+    lru.insert("a", 1);
+    lru.insert("b", 2);
+    lru.get(std::string_view("a"));
+    lru.insert("c", 3);
+    std::cout << "lru: a=" << lru.contains("a") << " b=" << lru.contains("b")
+              << " c=" << lru.contains("c") << std::endl;
+
+    // entries expire after their time to live
+    ConcurrentMap<std::string, int> ttl(4, 0, 50ms);
+    int calls = 0;
+    ttl.get_or_insert_with("key", [&calls]() { return ++calls; });
+    ttl.get_or_insert_with("key", [&calls]() { return ++calls; });
+    std::this_thread::sleep_for(60ms);
+    ttl.get_or_insert_with("key", [&calls]() { return ++calls; });
+    std::cout << "ttl: factory called " << calls << " times" << std::endl;
+
+    return 0;
+}
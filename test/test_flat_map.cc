@@ -0,0 +1,70 @@
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rautils/misc/map_handler.h"
+#include "rautils/string/strtool.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::DictIcHandler;
+using rayalto::utils::misc::FlatDictIcHandler;
+using rayalto::utils::string::kv_format;
+
+constexpr std::size_t ROUNDS = 100000;
+
+const std::vector<std::pair<std::string, std::string>> HEADERS {
+    {"Host", "example.com"},
+    {"User-Agent", "ra-utils/0.1"},
+    {"Accept", "text/html,application/xhtml+xml"},
+    {"Accept-Language", "en-US,en;q=0.5"},
+    {"Accept-Encoding", "gzip, deflate, br"},
+    {"Connection", "keep-alive"},
+    {"Cache-Control", "no-cache"},
+    {"Pragma", "no-cache"},
+    {"Sec-Fetch-Dest", "document"},
+    {"Sec-Fetch-Mode", "navigate"},
+    {"Upgrade-Insecure-Requests", "1"},
+    {"Referer", "https://example.com/"},
+};
+
+// build a header, look every name up and serialize it
+template <typename Header>
+std::string round() {
+    Header header;
+    for (const auto& [name, value] : HEADERS) {
+        header[name] = value;
+    }
+    std::size_t found = 0;
+    for (const auto& [name, value] : HEADERS) {
+        found += header.find(name)->second == value;
+    }
+    return std::to_string(found) + kv_format(header.base_container());
+}
+
+int main(int argc, char const* argv[]) {
+    FlatDictIcHandler header {{"b", "2"}, {"A", "1"}};
+    header["c"] = "3";
+    header.add({"a", "ignored"});
+    std::cout << kv_format(header.base_container()) << std::endl;
+
+    if (round<FlatDictIcHandler>() != round<DictIcHandler>()) {
+        std::cerr << "FlatMap and std::map disagree" << std::endl;
+        return 1;
+    }
+
+    if (bench::enabled(argc, argv)) {
+        std::cout << "std::map: "
+                  << bench::run(ROUNDS,
+                                []() { return round<DictIcHandler>().size(); })
+                  << " ns/round" << std::endl
+                  << "FlatMap:  "
+                  << bench::run(
+                         ROUNDS,
+                         []() { return round<FlatDictIcHandler>().size(); })
+                  << " ns/round" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rautils/misc/map_handler.h"
+#include "rautils/network/general/header.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::DictIC;
+using rayalto::utils::misc::FlatDictIcHandler;
+using rayalto::utils::network::general::Header;
+using rayalto::utils::network::general::header_id;
+using rayalto::utils::network::general::HeaderId;
+
+constexpr std::size_t ROUNDS = 100000;
+
+// a typical response, names spelled as curl hands them over
+const std::vector<std::pair<std::string, std::string>> RESPONSE {
+    {"date", "Mon, 19 Oct 2026 00:00:00 GMT"},
+    {"content-type", "application/json"},
+    {"content-length", "1024"},
+    {"connection", "keep-alive"},
+    {"server", "nginx"},
+    {"cache-control", "no-cache"},
+    {"etag", "\"33a64df551425fcc55e4d42a148795d9f25f89d4\""},
+    {"vary", "Accept-Encoding"},
+    {"strict-transport-security", "max-age=63072000"},
+    {"x-request-id", "5f2b1c3a"},
+};
+
+// fill, probe and iterate a header, return what was read, in whatever
+// order and spelling the header keeps names
+template <typename HeaderType>
+std::string round() {
+    HeaderType header;
+    for (const auto& [name, value] : RESPONSE) {
+        header[name] = value;
+    }
+    std::string read = header.find("Content-Length")->second;
+    read += header.find("Content-Type")->second;
+    for (const auto& [name, value] : header) {
+        read.append(name).append(value);
+    }
+    return read;
+}
+
+int main(int argc, char const* argv[]) {
+    static_assert(header_id("sec-websocket-key") == HeaderId::SEC_WEBSOCKET_KEY);
+
+    Header header {{"content-type", "text/plain"}, {"X-Foo", "bar"}};
+    header[HeaderId::USER_AGENT] = "ra-utils";
+    header.update({"x-foo", "baz"});
+    for (const auto& [name, value] : header) {
+        std::cout << name << ": " << value << std::endl;
+    }
+
+    // built from and turned back into a plain map
+    const DictIC map {{"host", "example.com"}, {"X-Foo", "bar"}};
+    Header from_map {map};
+    from_map.insert({{"Accept", "*/*"}});
+    if (from_map.base_container().size() != 3
+        || from_map.base_container().find("x-foo")->second != "bar") {
+        std::cerr << "base_container mismatch" << std::endl;
+        return 1;
+    }
+    from_map.erase(from_map.cbegin(), from_map.cend());
+    if (!from_map.empty()) {
+        std::cerr << "erase(first, last) left headers" << std::endl;
+        return 1;
+    }
+
+    if (round<Header>().size() != round<FlatDictIcHandler>().size()) {
+        std::cerr << "Header and FlatDictIcHandler disagree" << std::endl;
+        return 1;
+    }
+
+    if (bench::enabled(argc, argv)) {
+        std::cout << "FlatDictIcHandler: "
+                  << bench::run(
+                         ROUNDS,
+                         []() { return round<FlatDictIcHandler>().size(); })
+                  << " ns/round" << std::endl
+                  << "Header:            "
+                  << bench::run(ROUNDS,
+                                []() { return round<Header>().size(); })
+                  << " ns/round" << std::endl;
+    }
+    return 0;
+}
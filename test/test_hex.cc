@@ -0,0 +1,148 @@
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rautils/string/hex.h"
+#include "rautils/string/strtool.h"
+
+#include "bench.h"
+
+using rayalto::utils::string::hex_decode;
+using rayalto::utils::string::hex_encode;
+using rayalto::utils::string::hex_string;
+using rayalto::utils::string::parse_hex;
+
+// the byte-at-a-time versions these replace
+std::string naive_hex_string(const std::vector<unsigned char>& data,
+                             const bool& upper_case) {
+    const char* digits = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+    std::string result;
+    for (const unsigned char& byte : data) {
+        result.push_back(digits[byte >> 4]);
+        result.push_back(digits[byte & 0x0f]);
+    }
+    return result;
+}
+
+unsigned char naive_nibble(const char& c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return 0x0f;
+}
+
+std::vector<unsigned char> naive_parse_hex(const std::string& hex) {
+    std::vector<unsigned char> result;
+    for (std::size_t i = 0; i < hex.length(); i += 2) {
+        unsigned char byte = naive_nibble(hex[i]) << 4;
+        if (i + 1 < hex.length()) {
+            byte |= naive_nibble(hex[i + 1]);
+        }
+        result.push_back(byte);
+    }
+    return result;
+}
+
+// GB/s of input of the naive versions and the raw interface, from 1 KiB up
+// to 100 MiB
+void benchmark(std::mt19937& random_engine) {
+    std::uniform_int_distribution<int> byte(0, 255);
+    const std::size_t sizes[] {1 << 10, 1 << 16, 1 << 20, 100 << 20};
+    for (const std::size_t& size : sizes) {
+        std::vector<unsigned char> data(size);
+        for (unsigned char& b : data) {
+            b = static_cast<unsigned char>(byte(random_engine));
+        }
+        std::string hex(size * 2, '\0');
+        std::vector<unsigned char> decoded(size);
+        // about 256 MiB per measurement, at least one round
+        const std::size_t rounds = size >= (1 << 28) ? 1 : (1 << 28) / size;
+        const double bytes = static_cast<double>(size);
+        std::cout << size << " bytes:" << std::endl
+                  << "  encode  naive "
+                  << bytes / bench::run(rounds,
+                                        [&]() {
+                                            return naive_hex_string(data, false)
+                                                .size();
+                                        })
+                  << " GB/s, hex_encode "
+                  << bytes / bench::run(rounds,
+                                        [&]() {
+                                            hex_encode(
+                                                data.data(), size, hex.data());
+                                            return hex[0];
+                                        })
+                  << " GB/s" << std::endl
+                  << "  decode  naive "
+                  << bytes / bench::run(rounds,
+                                        [&]() {
+                                            return naive_parse_hex(hex).size();
+                                        })
+                  << " GB/s, hex_decode "
+                  << bytes / bench::run(rounds,
+                                        [&]() {
+                                            hex_decode(hex.data(),
+                                                       hex.length(),
+                                                       decoded.data());
+                                            return decoded[0];
+                                        })
+                  << " GB/s" << std::endl;
+    }
+}
+
+int main(int argc, char const* argv[]) {
+    // check against the naive versions, odd lengths and junk included
+    std::mt19937 random_engine(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<std::size_t> length(0, 300);
+    const std::string alphabet = "0123456789abcdefABCDEFxyz- \xff";
+    for (int i = 0; i < 20000; i++) {
+        std::vector<unsigned char> data(length(random_engine));
+        for (unsigned char& b : data) {
+            b = static_cast<unsigned char>(byte(random_engine));
+        }
+        const bool upper_case = i % 2 == 1;
+        if (hex_string(data, upper_case) != naive_hex_string(data, upper_case)
+            || parse_hex(naive_hex_string(data, upper_case)) != data) {
+            std::cerr << "hex_string mismatch, length " << data.size()
+                      << std::endl;
+            return 1;
+        }
+        std::string hex(length(random_engine), '\0');
+        for (char& c : hex) {
+            c = alphabet[byte(random_engine) % alphabet.length()];
+        }
+        if (parse_hex(hex) != naive_parse_hex(hex)) {
+            std::cerr << "parse_hex mismatch: " << hex << std::endl;
+            return 1;
+        }
+    }
+
+    // one larger buffer through the raw interface
+    const std::size_t size = 1 << 16;
+    std::vector<unsigned char> data(size);
+    for (unsigned char& b : data) {
+        b = static_cast<unsigned char>(byte(random_engine));
+    }
+    std::string hex(size * 2, '\0');
+    std::vector<unsigned char> decoded(size);
+    hex_encode(data.data(), size, hex.data());
+    hex_decode(hex.data(), hex.length(), decoded.data());
+    if (hex != naive_hex_string(data, false) || decoded != data) {
+        std::cerr << "round trip mismatch" << std::endl;
+        return 1;
+    }
+    if (bench::enabled(argc, argv)) {
+        benchmark(random_engine);
+    }
+    std::cout << "ok" << std::endl;
+    return 0;
+}
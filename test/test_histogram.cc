@@ -0,0 +1,35 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "rautils/misc/histogram.h"
+
+using rayalto::utils::misc::Histogram;
+
+int main(int /* argc */, char const* /* argv */[]) {
+    Histogram histogram;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&histogram, i]() -> void {
+            std::mt19937 random_engine(i);
+            std::exponential_distribution<double> distribution(1.0 / 1000.0);
+            for (int j = 0; j < 100000; ++j) {
+                histogram.record(
+                    static_cast<std::uint64_t>(distribution(random_engine)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    std::cout << "count: " << histogram.count() << std::endl
+              << "min: " << histogram.min() << std::endl
+              << "mean: " << histogram.mean() << std::endl
+              << "p50: " << histogram.percentile(50) << std::endl
+              << "p99: " << histogram.percentile(99) << std::endl
+              << "p99.9: " << histogram.percentile(99.9) << std::endl
+              << "max: " << histogram.max() << std::endl;
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rautils/misc/flat_map.h"
+#include "rautils/string/strtool.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::FlatMap;
+using rayalto::utils::string::join;
+using rayalto::utils::string::join_to;
+using rayalto::utils::string::kv_format;
+using rayalto::utils::string::kv_format_to;
+
+// the std::accumulate version this replaces
+std::string accumulate_join(const std::string& separator,
+                            const std::vector<std::string>& items) {
+    return std::accumulate(std::next(items.begin()),
+                           items.end(),
+                           items.front(),
+                           [&](std::string l, std::string r) -> std::string {
+                               return std::move(l) + separator + std::move(r);
+                           });
+}
+
+// the guessed reserve version this replaces
+std::string guessed_kv_format(const std::map<std::string, std::string>& kvs) {
+    std::size_t kv_index = 0;
+    std::string result;
+    result.reserve(kvs.size() * 8);
+    for (const auto& kv : kvs) {
+        result.append(kv.first);
+        result.push_back('=');
+        result.append(kv.second);
+        kv_index++;
+        if (kv_index != kvs.size()) {
+            result.append("; ");
+        }
+    }
+    return result;
+}
+
+// microseconds per call of `function` over `rounds` calls
+template <typename Function>
+double microseconds(const std::size_t& rounds, Function function) {
+    return bench::run(rounds, function) / 1000.0;
+}
+
+// std::accumulate against join, and the guessed reserve against kv_format
+void benchmark(const std::map<std::string, std::string>& cookies) {
+    const std::size_t item_counts[] {10, 100, 1000};
+    for (const std::size_t& item_count : item_counts) {
+        std::vector<std::string> items;
+        for (std::size_t i = 0; i < item_count; i++) {
+            items.push_back("item-" + std::to_string(i * 7919));
+        }
+        std::cout << "join " << item_count << " items: std::accumulate "
+                  << microseconds(
+                         4096 / item_count + 1,
+                         [&]() { return accumulate_join(", ", items).size(); })
+                  << " us, join "
+                  << microseconds(65536 / item_count + 1,
+                                  [&]() { return join(", ", items).size(); })
+                  << " us" << std::endl;
+    }
+
+    std::string cookie_header;
+    std::cout << "20 cookies: guessed reserve "
+              << microseconds(
+                     1 << 16,
+                     [&]() { return guessed_kv_format(cookies).size(); })
+              << " us, kv_format "
+              << microseconds(1 << 16,
+                              [&]() {
+                                  return kv_format(cookies,
+                                                   '=',
+                                                   false,
+                                                   ';',
+                                                   true,
+                                                   false)
+                                      .size();
+                              })
+              << " us, kv_format_to reused string "
+              << microseconds(1 << 16,
+                              [&]() {
+                                  cookie_header.clear();
+                                  return kv_format_to(cookie_header,
+                                                      cookies,
+                                                      '=',
+                                                      false,
+                                                      ';',
+                                                      true,
+                                                      false)
+                                      .size();
+                              })
+              << " us" << std::endl;
+}
+
+int main(int argc, char const* argv[]) {
+    const std::vector<std::string> words {"foo", "bar", "", "baz"};
+    const std::string_view views[] {"a", "b", "c"};
+    std::string url = "https://example.com/?";
+    const FlatMap<std::string, std::string> query {{"q", "rayalto"},
+                                                   {"page", "2"}};
+    if (join(", ", words) != "foo, bar, , baz"
+        || join(", ", words.begin(), words.end()) != "foo, bar, , baz"
+        || join("", views) != "abc" || join("-", {"x"}) != "x"
+        || !join("-", words.begin(), words.begin()).empty()
+        || join_to(url, "&", std::vector<const char*> {"a=1", "b=2"})
+               != "https://example.com/?a=1&b=2"
+        || kv_format(query, '=', false, '&', false, false) != "page=2&q=rayalto"
+        || kv_format(std::map<std::string, std::string> {}) != ""
+        || kv_format(query) != "page: 2, q: rayalto, ") {
+        std::cerr << "mismatch" << std::endl;
+        return 1;
+    }
+
+    const std::size_t item_counts[] {10, 100, 1000};
+    for (const std::size_t& item_count : item_counts) {
+        std::vector<std::string> items;
+        for (std::size_t i = 0; i < item_count; i++) {
+            items.push_back("item-" + std::to_string(i * 7919));
+        }
+        if (join(", ", items) != accumulate_join(", ", items)) {
+            std::cerr << "join mismatch" << std::endl;
+            return 1;
+        }
+    }
+
+    std::map<std::string, std::string> cookies;
+    for (int i = 0; i < 20; i++) {
+        cookies["session_cookie_" + std::to_string(i)] =
+            std::string(24 + i, 'v');
+    }
+    if (kv_format(cookies, '=', false, ';', true, false)
+        != guessed_kv_format(cookies)) {
+        std::cerr << "kv_format mismatch" << std::endl;
+        return 1;
+    }
+    // appending to a reused string
+    std::string cookie_header = "stale";
+    cookie_header.clear();
+    if (kv_format_to(cookie_header, cookies, '=', false, ';', true, false)
+        != guessed_kv_format(cookies)) {
+        std::cerr << "kv_format_to mismatch" << std::endl;
+        return 1;
+    }
+    if (bench::enabled(argc, argv)) {
+        benchmark(cookies);
+    }
+    std::cout << "ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "rautils/misc/atomic_queue.h"
+#include "rautils/misc/mpmc_queue.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::AtomicQueue;
+using rayalto::utils::misc::MpmcQueue;
+
+// run `producers` threads pushing and `consumers` threads popping `messages`
+// values in total, return million values per second, or a negative number if
+// values were lost or duplicated
+template <typename Push, typename Pop>
+double run(const std::uint64_t& messages,
+           const std::size_t& producers,
+           const std::size_t& consumers,
+           Push push,
+           Pop pop) {
+    std::vector<std::thread> threads;
+    std::uint64_t expected = 0;
+    std::vector<std::uint64_t> sums(consumers, 0);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t p = 0; p < producers; p++) {
+        const std::uint64_t begin = messages * p / producers;
+        const std::uint64_t end = messages * (p + 1) / producers;
+        for (std::uint64_t i = begin; i < end; i++) {
+            expected += i;
+        }
+        threads.emplace_back([&push, begin, end]() -> void {
+            for (std::uint64_t i = begin; i < end; i++) {
+                while (!push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::size_t c = 0; c < consumers; c++) {
+        const std::uint64_t share = messages * (c + 1) / consumers
+                                    - messages * c / consumers;
+        threads.emplace_back([&pop, &sums, c, share]() -> void {
+            std::uint64_t value = 0;
+            for (std::uint64_t i = 0; i < share; i++) {
+                while (!pop(value)) {
+                    std::this_thread::yield();
+                }
+                sums[c] += value;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const double seconds = bench::seconds_since(start);
+    std::uint64_t sum = 0;
+    for (const std::uint64_t& s : sums) {
+        sum += s;
+    }
+    if (sum != expected) {
+        return -1.0;
+    }
+    return static_cast<double>(messages) / seconds / 1e6;
+}
+
+int main(int argc, char const* argv[]) {
+    // a short stress run unless benchmarking
+    const bool benchmark = bench::enabled(argc, argv);
+    const std::uint64_t messages = benchmark ? 1 << 20 : 1 << 16;
+    const std::size_t max_threads = benchmark ? 64 : 4;
+    if (benchmark) {
+        std::cout << "threads\tMpmcQueue(M/s)\tAtomicQueue(M/s)" << std::endl;
+    }
+    for (std::size_t threads = 2; threads <= max_threads; threads *= 2) {
+        const std::size_t producers = threads / 2;
+        const std::size_t consumers = threads - producers;
+
+        MpmcQueue<std::uint64_t> mpmc_queue(4096);
+        const double mpmc = run(
+            messages,
+            producers,
+            consumers,
+            [&](const std::uint64_t& value) -> bool {
+                return mpmc_queue.try_push(value);
+            },
+            [&](std::uint64_t& value) -> bool {
+                return mpmc_queue.try_pop(value);
+            });
+        if (mpmc < 0.0) {
+            std::cerr << "lost or duplicated values" << std::endl;
+            return 1;
+        }
+        if (!benchmark) {
+            continue;
+        }
+
+        AtomicQueue<std::uint64_t> atomic_queue;
+        const double atomic = run(
+            messages,
+            producers,
+            consumers,
+            [&](const std::uint64_t& value) -> bool {
+                atomic_queue.push(value);
+                return true;
+            },
+            [&](std::uint64_t& value) -> bool {
+                return atomic_queue.pop_into(value);
+            });
+
+        std::cout << threads << '\t' << mpmc << '\t' << atomic << std::endl;
+    }
+
+    // batches
+    MpmcQueue<int> queue(8);
+    std::vector<int> in {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::vector<int> out;
+    std::cout << "pushed " << queue.try_push_bulk(in.begin(), in.end())
+              << " of " << in.size() << " into capacity " << queue.capacity()
+              << ", popped " << queue.try_pop_bulk(std::back_inserter(out), 5)
+              << std::endl;
+
+    // values without a default constructor
+    struct Id {
+        explicit Id(const int& value) : value(value) {}
+        int value;
+    };
+    MpmcQueue<Id> ids(4);
+    ids.try_emplace(1);
+    ids.try_emplace(2);
+    std::vector<Id> popped;
+    if (ids.try_pop_bulk(std::back_inserter(popped), 4) != 2
+        || popped[0].value != 1 || popped[1].value != 2) {
+        std::cerr << "try_pop_bulk mismatch" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
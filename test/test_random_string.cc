@@ -0,0 +1,159 @@
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rautils/exceptions/exceptions.h"
+#include "rautils/string/random_string.h"
+#include "rautils/string/strtool.h"
+
+#include "bench.h"
+
+using rayalto::utils::exceptions::Exception;
+using rayalto::utils::string::random_string;
+using rayalto::utils::string::RandomString;
+
+constexpr std::size_t ROUNDS = 1 << 20;
+constexpr std::size_t ID_LENGTH = 16;
+
+// the version this replaces: new engine, seeded from random_device per call
+std::string mt19937_random_string(const std::size_t& len,
+                                  const std::string_view& characters) {
+    std::random_device r_device;
+    std::mt19937 random_engine(r_device());
+    std::uniform_int_distribution<std::size_t> distribution(
+        0, characters.size() - 1);
+    std::string result(len, '\0');
+    for (char& c : result) {
+        c = characters[distribution(random_engine)];
+    }
+    return result;
+}
+
+// millions of ids per second
+template <typename Function>
+double ids_per_second(const std::size_t& rounds, Function function) {
+    return 1e3 / bench::run(rounds, [&function]() {
+        return static_cast<unsigned char>(function()[0]);
+    });
+}
+
+// the per call mt19937 version against the ways of making an id
+void benchmark(RandomString& ids, RandomString& secure_ids) {
+    const std::string_view characters(RandomString::ALPHANUMERIC);
+    char buffer[ID_LENGTH];
+    std::cout << ID_LENGTH << " character ids, millions per second:"
+              << std::endl
+              << "  mt19937 per call "
+              << ids_per_second(ROUNDS / 64,
+                                [&]() {
+                                    return mt19937_random_string(ID_LENGTH,
+                                                                 characters);
+                                })
+              << ", random_string() "
+              << ids_per_second(ROUNDS,
+                                []() { return random_string(ID_LENGTH); })
+              << ", RandomString "
+              << ids_per_second(ROUNDS, [&]() { return ids(ID_LENGTH); })
+              << ", RandomString::fill "
+              << ids_per_second(ROUNDS,
+                                [&]() {
+                                    ids.fill(buffer, ID_LENGTH);
+                                    return buffer;
+                                })
+              << ", Source::SECURE "
+              << ids_per_second(ROUNDS / 4,
+                                [&]() { return secure_ids(ID_LENGTH); })
+              << std::endl;
+}
+
+// whether every character of `alphabet` shows up about equally often
+bool uniform(RandomString& random, const std::string& alphabet) {
+    std::vector<std::size_t> counts(256, 0);
+    const std::size_t length = alphabet.length() * 4096;
+    for (const char& c : random(length)) {
+        counts[static_cast<unsigned char>(c)] += 1;
+    }
+    for (const char& c : alphabet) {
+        const std::size_t count = counts[static_cast<unsigned char>(c)];
+        // 4096 expected, a deviation of 8 sigma never happens by chance
+        if (count < 4096 - 512 || count > 4096 + 512) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char const* argv[]) {
+    // 200 characters: 56 of the 256 byte values are rejected
+    std::string alphabet;
+    for (int c = 0; c < 200; c++) {
+        alphabet.push_back(static_cast<char>(c + 32));
+    }
+    RandomString fast {alphabet};
+    RandomString secure {alphabet, RandomString::Source::SECURE};
+    RandomString seeded {"01", 42};
+    if (!uniform(fast, alphabet) || !uniform(secure, alphabet)
+        || !uniform(seeded, "01")) {
+        std::cerr << "not uniform" << std::endl;
+        return 1;
+    }
+    if (RandomString {"abc", 7}(64) != RandomString {"abc", 7}(64)
+        || RandomString {"abc", 7}(64) == RandomString {"abc", 8}(64)) {
+        std::cerr << "seeding mismatch" << std::endl;
+        return 1;
+    }
+    // more than 256 characters take two bytes each, the first 44 bytes are
+    // in this alphabet twice
+    std::string wide;
+    for (int i = 0; i < 300; i++) {
+        wide.push_back(static_cast<char>(i));
+    }
+    RandomString wide_random {wide, 1};
+    std::vector<std::size_t> counts(256, 0);
+    for (const char& c : wide_random(300 * 1000)) {
+        counts[static_cast<unsigned char>(c)] += 1;
+    }
+    for (std::size_t byte = 0; byte < counts.size(); byte++) {
+        const std::size_t expected = byte < 44 ? 2000 : 1000;
+        if (counts[byte] < expected - 250 || counts[byte] > expected + 250) {
+            std::cerr << "wide alphabet not uniform" << std::endl;
+            return 1;
+        }
+    }
+    try {
+        RandomString empty {""};
+        std::cerr << "empty alphabet accepted" << std::endl;
+        return 1;
+    }
+    catch (const Exception& e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    // every way of making an id stays within the alphabet
+    const std::string_view characters(RandomString::ALPHANUMERIC);
+    RandomString ids;
+    RandomString secure_ids {RandomString::ALPHANUMERIC,
+                             RandomString::Source::SECURE};
+    char buffer[ID_LENGTH];
+    ids.fill(buffer, ID_LENGTH);
+    const std::string generated[] {random_string(ID_LENGTH),
+                                   ids(ID_LENGTH),
+                                   secure_ids(ID_LENGTH),
+                                   std::string(buffer, ID_LENGTH)};
+    for (const std::string& id : generated) {
+        if (id.length() != ID_LENGTH
+            || id.find_first_not_of(characters) != std::string::npos) {
+            std::cerr << "bad id: " << id << std::endl;
+            return 1;
+        }
+        std::cout << id << std::endl;
+    }
+
+    if (bench::enabled(argc, argv)) {
+        benchmark(ids, secure_ids);
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rautils/string/search.h"
+#include "rautils/string/strtool.h"
+
+#include "bench.h"
+
+using rayalto::utils::string::AhoCorasick;
+using rayalto::utils::string::count;
+using rayalto::utils::string::exists;
+using rayalto::utils::string::find_first;
+
+constexpr std::size_t NPOS = std::string_view::npos;
+
+// microseconds per call of `function` over `rounds` calls
+template <typename Function>
+double microseconds(const std::size_t& rounds, Function function) {
+    return bench::run(rounds, function) / 1000.0;
+}
+
+// std::string::find against find_first, and one find_first per marker
+// against AhoCorasick, on a 1 MiB body
+void benchmark(std::mt19937& random_engine) {
+    std::uniform_int_distribution<int> printable(' ', '}');
+    std::string body(1 << 20, '\0');
+    for (char& c : body) {
+        c = static_cast<char>(printable(random_engine));
+    }
+    body.back() = '~';
+    const std::size_t needle_lengths[] {2, 8, 32, 128};
+    for (const std::size_t& needle_length : needle_lengths) {
+        const std::string needle = body.substr(body.length() - needle_length);
+        std::cout << "needle of " << needle_length << " bytes in 1 MiB: "
+                  << "std::string::find "
+                  << microseconds(64, [&]() { return body.find(needle); })
+                  << " us, find_first "
+                  << microseconds(64,
+                                  [&]() { return find_first(body, needle); })
+                  << " us" << std::endl;
+    }
+    // every position is a candidate and fails late
+    const std::string periodic(1 << 20, 'a');
+    const std::string needle =
+        std::string(31, 'a') + 'b' + std::string(32, 'a');
+    std::cout << "periodic text in 1 MiB: std::string::find "
+              << microseconds(4, [&]() { return periodic.find(needle); })
+              << " us, find_first "
+              << microseconds(4, [&]() { return find_first(periodic, needle); })
+              << " us" << std::endl;
+
+    const std::vector<std::string> markers {"<script",
+                                            "javascript:",
+                                            "onerror=",
+                                            "onload=",
+                                            "<iframe",
+                                            "document.cookie",
+                                            "eval(",
+                                            "base64,",
+                                            "<object",
+                                            "srcdoc=",
+                                            "expression(",
+                                            "vbscript:",
+                                            "<embed",
+                                            "formaction=",
+                                            "<svg",
+                                            "data:text/html"};
+    // more markers cost find_first another pass each, AhoCorasick nothing
+    const std::size_t marker_counts[] {16, 128};
+    for (const std::size_t& marker_count : marker_counts) {
+        std::vector<std::string> patterns;
+        for (std::size_t i = 0; i < marker_count; i++) {
+            patterns.push_back(markers[i % markers.size()]
+                               + std::string(i / markers.size(), '"'));
+        }
+        const AhoCorasick automaton {patterns};
+        std::cout << marker_count << " markers in 1 MiB: find_first per marker "
+                  << microseconds(4,
+                                  [&]() {
+                                      std::size_t found = 0;
+                                      for (const std::string& pattern :
+                                           patterns) {
+                                          found += count(body, pattern);
+                                      }
+                                      return found;
+                                  })
+                  << " us, AhoCorasick "
+                  << microseconds(4,
+                                  [&]() {
+                                      std::size_t found = 0;
+                                      automaton.for_each(
+                                          body,
+                                          [&found](const AhoCorasick::Match&) {
+                                              found += 1;
+                                          });
+                                      return found;
+                                  })
+                  << " us" << std::endl;
+    }
+}
+
+int main(int argc, char const* argv[]) {
+    // check against std::string_view::find on a small alphabet, so there
+    // are plenty of partial matches
+    std::mt19937 random_engine(42);
+    // mostly 'a' every other round, which pushes find_first into Two-Way
+    std::uniform_int_distribution<int> letter(0, 2);
+    std::uniform_int_distribution<int> skewed(0, 19);
+    bool skew = false;
+    std::uniform_int_distribution<std::size_t> length(0, 200);
+    auto random_text = [&](const std::size_t& text_length) {
+        std::string text(text_length, '\0');
+        for (char& c : text) {
+            c = skew ? (skewed(random_engine) == 0 ? 'b' : 'a')
+                     : static_cast<char>('a' + letter(random_engine));
+        }
+        return text;
+    };
+    for (int i = 0; i < 20000; i++) {
+        skew = i % 2 == 1;
+        const std::string haystack =
+            random_text(length(random_engine) * (skew ? 20 : 1));
+        const std::string needle = random_text(length(random_engine) % 40);
+        // about 32 start positions per haystack, past the end included
+        const std::size_t step = 1 + haystack.length() / 32;
+        for (std::size_t pos = 0; pos <= haystack.length() + 1; pos += step) {
+            const std::size_t expected =
+                std::string_view(haystack).find(needle, pos);
+            if (find_first(haystack, needle, pos) != expected) {
+                std::cerr << "find mismatch: " << haystack << " / " << needle
+                          << " from " << pos << std::endl;
+                return 1;
+            }
+        }
+        if (exists(haystack, needle)
+            != (haystack.find(needle) != std::string::npos)) {
+            std::cerr << "exists mismatch" << std::endl;
+            return 1;
+        }
+    }
+    if (count("aaaa", "aa") != 2 || count("abc", "") != 0
+        || !exists("hello", "ll") || exists("hello", "lo!")) {
+        std::cerr << "count/exists mismatch" << std::endl;
+        return 1;
+    }
+
+    skew = false;
+
+    // check against searching every pattern separately
+    for (int i = 0; i < 2000; i++) {
+        std::vector<std::string> patterns;
+        const std::size_t pattern_count = 1 + length(random_engine) % 8;
+        for (std::size_t j = 0; j < pattern_count; j++) {
+            patterns.push_back(random_text(length(random_engine) % 5));
+        }
+        const std::string text = random_text(length(random_engine));
+        std::vector<std::pair<std::size_t, std::size_t>> expected;
+        for (std::size_t p = 0; p < patterns.size(); p++) {
+            for (std::size_t pos = patterns[p].empty() ? NPOS
+                                                       : text.find(patterns[p]);
+                 pos != NPOS;
+                 pos = text.find(patterns[p], pos + 1)) {
+                expected.emplace_back(pos + patterns[p].length(), p);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        std::vector<std::pair<std::size_t, std::size_t>> found;
+        const AhoCorasick automaton {patterns};
+        for (const AhoCorasick::Match& match : automaton.find_all(text)) {
+            found.emplace_back(
+                match.position + patterns[match.pattern].length(),
+                match.pattern);
+        }
+        std::sort(found.begin(), found.end());
+        if (found != expected
+            || automaton.contains(text) != !expected.empty()) {
+            std::cerr << "aho-corasick mismatch: " << text << std::endl;
+            return 1;
+        }
+    }
+    const AhoCorasick folded {{"Content-Type", "BOUNDARY"}, true};
+    const std::optional<AhoCorasick::Match> match =
+        folded.find("--- content-type: multipart; boundary=x");
+    if (!match.has_value() || match->pattern != 0 || match->position != 4
+        || folded.find_all("BoUnDaRy content-TYPE").size() != 2) {
+        std::cerr << "case insensitive mismatch" << std::endl;
+        return 1;
+    }
+
+    // long haystacks, with the needle only at the very end, which runs
+    // the vectorized filter past many blocks
+    std::uniform_int_distribution<int> printable(' ', '}');
+    std::string body(1 << 16, '\0');
+    for (char& c : body) {
+        c = static_cast<char>(printable(random_engine));
+    }
+    body.back() = '~';
+    const std::size_t needle_lengths[] {2, 8, 32, 128};
+    for (const std::size_t& needle_length : needle_lengths) {
+        const std::string needle = body.substr(body.length() - needle_length);
+        if (find_first(body, needle) != body.find(needle)) {
+            std::cerr << "long haystack mismatch, needle of " << needle_length
+                      << " bytes" << std::endl;
+            return 1;
+        }
+    }
+    // every position is a candidate and fails late
+    const std::string periodic(1 << 16, 'a');
+    const std::string needle =
+        std::string(31, 'a') + 'b' + std::string(32, 'a');
+    if (find_first(periodic, needle) != NPOS
+        || find_first(periodic + needle, needle) != periodic.length()) {
+        std::cerr << "periodic text mismatch" << std::endl;
+        return 1;
+    }
+    if (bench::enabled(argc, argv)) {
+        benchmark(random_engine);
+    }
+    std::cout << "ok" << std::endl;
+    return 0;
+}
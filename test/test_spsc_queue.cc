@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "rautils/misc/spsc_queue.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::SpscQueue;
+
+int main(int argc, char const* argv[]) {
+    const bool benchmark = bench::enabled(argc, argv);
+    const std::uint64_t messages = benchmark ? 1 << 24 : 1 << 16;
+    SpscQueue<std::uint64_t> queue(4096);
+    std::uint64_t sum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&queue, messages]() -> void {
+        for (std::uint64_t i = 0; i < messages; i++) {
+            while (!queue.try_emplace(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::thread consumer([&queue, &sum, messages]() -> void {
+        std::uint64_t received = 0;
+        while (received < messages) {
+            const std::size_t consumed = queue.consume_all(
+                [&sum](const std::uint64_t& value) -> void { sum += value; });
+            if (consumed == 0) {
+                std::this_thread::yield();
+            }
+            received += consumed;
+        }
+    });
+    producer.join();
+    consumer.join();
+    const double seconds = bench::seconds_since(start);
+
+    std::cout << "sum: " << sum << " (expected "
+              << messages * (messages - 1) / 2 << ')' << std::endl;
+    if (benchmark) {
+        std::cout << "throughput: "
+                  << static_cast<double>(messages) / seconds / 1e6
+                  << "M ops/s" << std::endl;
+    }
+
+    // in-place access
+    SpscQueue<std::string> strings(2);
+    strings.try_emplace(3, 'a');
+    strings.try_push("bb");
+    std::cout << "full: " << !strings.try_push("ccc") << std::endl;
+    while (std::string* front = strings.front()) {
+        std::cout << *front << std::endl;
+        strings.pop();
+    }
+
+    return 0;
+}
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // NOLINTNEXTLINE(google-build-using-namespace)
@@ -20,5 +21,18 @@ int main(int /* argc */, char const* /*  argv */[]) {
         << std::endl
         << string::count("😄😄😄😅😄😄😄😄😄😅😄😄😄😄", "😅") << std::endl;
 
+    // tokens are views into the original string, nothing is allocated
+    for (const std::string_view& pair :
+         string::split_view("  a = 1 ;b=2;; c =3 ", ';')) {
+        const auto [key, value] = string::split_once_view(pair, '=');
+        std::cout << '[' << string::strip_view(key) << "] = ["
+                  << string::strip_view(value) << ']' << std::endl;
+    }
+    for (const std::string_view& part :
+         string::split_view("foo::bar::::baz", "::")) {
+        std::cout << '[' << string::strip_view(part, "az") << ']';
+    }
+    std::cout << std::endl;
+
     return 0;
 }
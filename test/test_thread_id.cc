@@ -13,5 +13,14 @@ int main(int /* argc */, char const* /* argv */[]) {
         t.detach();
     }
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // ids of exited threads are reused, so these all print the same id
+    for (int i = 0; i < 3; ++i) {
+        std::thread t([&]() -> void {
+            std::printf("recycled: %d\n", rayalto::utils::misc::thread_id());
+        });
+        t.join();
+    }
+    std::printf("max: %d\n", rayalto::utils::misc::max_thread_id());
     return 0;
 }
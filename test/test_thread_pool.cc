@@ -0,0 +1,69 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "rautils/misc/thread_pool.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::ThreadPool;
+
+// naive on purpose, uneven work per call to exercise stealing
+std::uint64_t fibonacci(const std::uint64_t& n) {
+    return n < 2 ? n : fibonacci(n - 1) + fibonacci(n - 2);
+}
+
+int main(int argc, char const* argv[]) {
+    ThreadPool pool;
+    std::cout << "workers: " << pool.size() << std::endl;
+
+    std::vector<std::future<std::uint64_t>> futures;
+    for (std::uint64_t n = 20; n < 30; n++) {
+        futures.emplace_back(pool.submit(fibonacci, n));
+    }
+    for (std::future<std::uint64_t>& future : futures) {
+        std::cout << future.get() << ' ';
+    }
+    std::cout << std::endl;
+
+    // tasks spawning tasks land on the worker's own deque
+    std::future<std::uint64_t> nested = pool.submit([&pool]() {
+        std::future<std::uint64_t> left = pool.submit(fibonacci, 25);
+        std::uint64_t right = fibonacci(24);
+        while (left.wait_for(std::chrono::seconds(0))
+               != std::future_status::ready) {
+            pool.run_pending_task();
+        }
+        return left.get() + right;
+    });
+    std::cout << "fib(26): " << nested.get() << std::endl;
+
+    std::vector<std::uint64_t> squares(1 << 20);
+    const auto start = std::chrono::steady_clock::now();
+    pool.parallel_for(std::size_t {0}, squares.size(), [&](std::size_t i) {
+        squares[i] = static_cast<std::uint64_t>(i) * i;
+    });
+    const double seconds = bench::seconds_since(start);
+    std::cout << "parallel_for sum: "
+              << std::accumulate(squares.begin(), squares.end(),
+                                 std::uint64_t {0});
+    if (bench::enabled(argc, argv)) {
+        std::cout << " in " << seconds * 1000 << "ms";
+    }
+    std::cout << std::endl;
+
+    std::future<void> failing =
+        pool.submit([]() { throw std::runtime_error("expected"); });
+    try {
+        failing.get();
+    }
+    catch (const std::exception& e) {
+        std::cout << "exception: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
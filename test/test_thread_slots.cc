@@ -0,0 +1,54 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "rautils/misc/thread_slots.h"
+
+#include "bench.h"
+
+using rayalto::utils::misc::ShardedCounter;
+
+constexpr int THREADS = 8;
+
+int main(int argc, char const* argv[]) {
+    const bool benchmark = bench::enabled(argc, argv);
+    const std::int64_t adds = benchmark ? 1000000 : 10000;
+    ShardedCounter sharded;
+    std::atomic<std::int64_t> shared = 0;
+
+    auto run = [adds](auto&& add) -> double {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < THREADS; ++i) {
+            threads.emplace_back([&add, adds]() -> void {
+                for (std::int64_t j = 0; j < adds; ++j) {
+                    add();
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return bench::seconds_since(start);
+    };
+
+    const double sharded_seconds = run([&sharded]() { sharded.add(); });
+    const double shared_seconds =
+        run([&shared]() { shared.fetch_add(1, std::memory_order_relaxed); });
+
+    if (sharded.value() != THREADS * adds) {
+        std::cerr << "ShardedCounter lost adds: " << sharded.value()
+                  << std::endl;
+        return 1;
+    }
+    if (benchmark) {
+        std::cout << "ShardedCounter: " << sharded.value() << " in "
+                  << sharded_seconds * 1000 << "ms" << std::endl
+                  << "std::atomic: " << shared.load() << " in "
+                  << shared_seconds * 1000 << "ms" << std::endl;
+    }
+    return 0;
+}
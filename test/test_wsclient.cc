@@ -1,4 +1,6 @@
 #include <chrono>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <thread>
 
@@ -15,6 +17,12 @@ using rayalto::utils::network::websocket::CloseStatus;
 
 int main(int /* argc */, char const* /* argv */[]) {
     Client client;
+    client.deflate_setting(Client::DeflateSetting {});
+    client.reconnect_setting(Client::ReconnectSetting {});
+    client.keepalive_setting(Client::KeepaliveSetting {});
+    client.fragment_size(4096);
+    // keep handlers off the service thread
+    client.executor(Client::thread_pool(2));
     client.on_error(
         [&](Client& /* client */, const std::string& message) -> void {
             std::cerr << "Error: " << message << std::endl;
@@ -36,6 +44,17 @@ int main(int /* argc */, char const* /* argv */[]) {
                               message.binary()))
                   << std::endl;
     });
+    std::size_t received = 0;
+    client.on_fragment([&](Client& /* client */,
+                           const Client::Fragment& fragment,
+                           bool /* is_first */,
+                           bool is_final) -> void {
+        received += fragment.length;
+        if (is_final) {
+            std::cout << "Received " << received << " bytes" << std::endl;
+            received = 0;
+        }
+    });
     client.connect(Url("wss://test.rayalto.top:8443"));
     std::this_thread::sleep_for(std::chrono::seconds(1));
     client.send(Message("hello world"));
@@ -45,9 +64,42 @@ int main(int /* argc */, char const* /* argv */[]) {
     client.connect(Url("ws://127.0.0.1:8080"));
     std::this_thread::sleep_for(std::chrono::seconds(1));
     client.send(Message("hello world"));
+    // 16 KiB text pulled in 4 KiB frames
+    std::size_t streamed = 0;
+    client.send_stream(Message::Type::TEXT,
+                       [&](Client& /* client */,
+                           unsigned char* buffer,
+                           std::size_t length,
+                           bool& final) -> std::size_t {
+                           std::memset(buffer, 'a', length);
+                           streamed += length;
+                           final = streamed >= 16 * 1024;
+                           return length;
+                       });
     std::this_thread::sleep_for(std::chrono::seconds(1));
     client.disconnect("bye", CloseStatus::NORMAL);
     std::this_thread::sleep_for(std::chrono::seconds(1));
 
+    Client::Stats stats = client.stats();
+    std::cout << "Compression ratio in: " << stats.compression_ratio_in()
+              << ", out: " << stats.compression_ratio_out() << std::endl;
+    std::cout << "Unexpected closes: " << stats.unexpected_closes
+              << ", reconnects: " << stats.reconnects << '/'
+              << stats.reconnect_attempts << std::endl;
+    std::cout << "Frames in/out: " << stats.frames_in << '/' << stats.frames_out
+              << ", bytes in/out: " << stats.bytes_in << '/' << stats.bytes_out
+              << ", peak queued bytes: " << stats.peak_queued_bytes
+              << ", writable callbacks: " << stats.writable_callbacks
+              << ", partial writes: " << stats.partial_writes << std::endl;
+    std::cout << "Callbacks: " << stats.callbacks << " in "
+              << stats.callback_nanoseconds << "ns" << std::endl;
+    std::cout << "Callback delivery p50: "
+              << client.delivery_latency().percentile(50)
+              << "ns, p99: " << client.delivery_latency().percentile(99)
+              << "ns" << std::endl;
+    std::cout << "RTT p50: " << client.rtt().percentile(50)
+              << "us, p99: " << client.rtt().percentile(99) << "us"
+              << std::endl;
+
     return 0;
 }
@@ -0,0 +1,133 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "rautils/exceptions/exceptions.h"
+#include "rautils/misc/histogram.h"
+#include "rautils/network/general/url.h"
+#include "rautils/network/websocket.h"
+#include "rautils/network/websocket/close_status.h"
+#include "rautils/network/websocket/message.h"
+
+using rayalto::utils::misc::Histogram;
+using rayalto::utils::network::general::Url;
+using rayalto::utils::network::websocket::Client;
+using rayalto::utils::network::websocket::CloseStatus;
+using rayalto::utils::network::websocket::Message;
+using rayalto::utils::network::websocket::Recorder;
+using rayalto::utils::network::websocket::Recording;
+using rayalto::utils::network::websocket::ReplayServer;
+
+// the message handler under test
+std::size_t handle(const Message& message) {
+    std::size_t commas = 0;
+    for (const char& c : message.text()) {
+        commas += c == ',' ? 1 : 0;
+    }
+    return commas;
+}
+
+int main(int argc, char const* argv[]) {
+    // keep the files of parallel or repeated runs apart
+    const std::filesystem::path dir =
+        std::filesystem::temp_directory_path()
+        / ("wsreplay-" + std::to_string(std::random_device {}()));
+    std::filesystem::create_directories(dir);
+
+    // replay a file recorded with Recorder, or a synthetic feed
+    Recording recording;
+    if (argc > 1) {
+        recording = Recording::load(argv[1]);
+    }
+    else {
+        for (std::uint64_t i = 0; i < 100000; i++) {
+            recording.add(i * 10,
+                          Message(R"({"id":)" + std::to_string(i)
+                                  + R"(,"price":1.5,"size":3})"));
+        }
+        recording.save((dir / "wsreplay.rec").string());
+    }
+    std::cout << "Replaying " << recording.size() << " messages ("
+              << recording.duration() << "us recorded)" << std::endl;
+
+    // as fast as possible, use 1 for the recorded pace
+    ReplayServer server(recording);
+    server.speed(0);
+    // another run may hold the port, try the next ones
+    std::uint16_t port = 7681;
+    for (;; port++) {
+        try {
+            server.start(port);
+            break;
+        }
+        catch (const rayalto::utils::exceptions::Exception&) {
+            if (port == 7681 + 63) {
+                throw;
+            }
+        }
+    }
+
+    Histogram handler_latency;
+    std::size_t received = 0;
+    std::size_t checksum = 0;
+    std::chrono::steady_clock::time_point first;
+    std::chrono::steady_clock::time_point last;
+    // set on the service thread, released so the counters above are
+    // visible once the loop below sees it
+    std::atomic<bool> closed {false};
+
+    Client client;
+    Recorder recorder((dir / "wsreplay.out.rec").string());
+    client.on_error([&](Client& /* client */, const std::string& message) {
+        std::cerr << "Error: " << message << std::endl;
+        closed.store(true, std::memory_order_release);
+    });
+    client.on_receive([&](Client& /* client */, const Message& message) {
+        const auto begin = std::chrono::steady_clock::now();
+        if (received == 0) {
+            first = begin;
+        }
+        checksum += handle(message);
+        last = std::chrono::steady_clock::now();
+        handler_latency.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(last - begin)
+                .count()));
+        recorder.record(message);
+        ++received;
+    });
+    client.on_close([&](Client& /* client */,
+                        const CloseStatus& /* close_status */,
+                        const std::string& /* message */) {
+        closed.store(true, std::memory_order_release);
+    });
+    client.connect(Url("ws://127.0.0.1:" + std::to_string(port)));
+
+    while (!closed.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    server.stop();
+    recorder.flush();
+
+    const double seconds =
+        std::chrono::duration<double>(last - first).count();
+    std::cout << "Received " << received << '/' << server.sent()
+              << " messages (checksum " << checksum << ')' << std::endl;
+    std::cout << "Throughput: "
+              << (seconds > 0 ? static_cast<double>(received) / seconds : 0)
+              << " msg/s" << std::endl;
+    std::cout << "Handler latency (ns) p50: "
+              << handler_latency.percentile(50)
+              << ", p99: " << handler_latency.percentile(99)
+              << ", p99.9: " << handler_latency.percentile(99.9)
+              << ", max: " << handler_latency.max() << std::endl;
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    return 0;
+}